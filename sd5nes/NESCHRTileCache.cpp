@@ -0,0 +1,31 @@
+#include "NESCHRTileCache.h"
+
+#include <algorithm>
+
+
+NESCHRTileCache::NESCHRTileCache(const NESMemCHRBank& chr) :
+chr_(chr)
+{
+	isTileDecoded_.fill(false);
+}
+
+
+NESCHRTileCache::~NESCHRTileCache()
+{
+}
+
+
+void NESCHRTileCache::DecodeTile(u16 tileIndex)
+{
+	auto& tile = tiles_[tileIndex];
+	const u16 tileAddr = tileIndex * 16;
+
+	for (u8 y = 0; y < 8; ++y)
+	{
+		// The low bitplane is stored in the first 8 bytes of the tile, and the high bitplane in the last 8.
+		tile.rows[y] = DecodeRow(chr_.Read8(tileAddr + y), chr_.Read8(tileAddr + 8 + y));
+		std::reverse_copy(tile.rows[y].begin(), tile.rows[y].end(), tile.flippedRows[y].begin());
+	}
+
+	isTileDecoded_[tileIndex] = true;
+}
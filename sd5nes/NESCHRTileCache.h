@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+
+#include "NESTypes.h"
+#include "NESMemory.h"
+
+/* Amount of 16-byte tiles in an 8KB CHR bank. */
+#define NES_CHR_TILES_PER_BANK 0x200
+
+/**
+* A row of a decoded tile: the 2-bit pixel values of its 8 pixels, from left to right.
+*/
+typedef std::array<u8, 8> NESCHRTileRow;
+
+/**
+* A decoded 8x8 tile, along with its horizontally flipped variant.
+*/
+struct NESCHRDecodedTile
+{
+	std::array<NESCHRTileRow, 8> rows;
+	std::array<NESCHRTileRow, 8> flippedRows;
+};
+
+/**
+* Cache of the decoded tiles of an 8KB CHR bank.
+* Tiles are decoded the first time they're used after being invalidated,
+* so the bitplanes of a tile are only decoded once no matter how many times it is drawn.
+*/
+class NESCHRTileCache
+{
+public:
+	explicit NESCHRTileCache(const NESMemCHRBank& chr);
+	~NESCHRTileCache();
+
+	/**
+	* Gets the decoded tile containing the specified address of the CHR bank.
+	*/
+	inline const NESCHRDecodedTile& GetTile(u16 addr)
+	{
+		const u16 tileIndex = (addr & 0x1FFF) / 16;
+		if (!isTileDecoded_[tileIndex])
+			DecodeTile(tileIndex);
+
+		return tiles_[tileIndex];
+	}
+
+	/**
+	* Invalidates the tile containing the specified address of the CHR bank.
+	* Must be called after writing to the CHR bank.
+	*/
+	inline void Invalidate(u16 addr) { isTileDecoded_[(addr & 0x1FFF) / 16] = false; }
+
+	/**
+	* Decodes a row of a tile from its low and high bitplane bytes.
+	*/
+	static inline NESCHRTileRow DecodeRow(u8 bitmapLo, u8 bitmapHi)
+	{
+		NESCHRTileRow row;
+		for (u8 x = 0; x < 8; ++x)
+			row[x] = (((bitmapHi >> (7 - x)) & 1) << 1) | ((bitmapLo >> (7 - x)) & 1);
+
+		return row;
+	}
+
+private:
+	const NESMemCHRBank& chr_;
+
+	std::array<NESCHRDecodedTile, NES_CHR_TILES_PER_BANK> tiles_;
+	std::array<bool, NES_CHR_TILES_PER_BANK> isTileDecoded_;
+
+	/**
+	* Decodes the bitplanes of the specified tile.
+	*/
+	void DecodeTile(u16 tileIndex);
+};
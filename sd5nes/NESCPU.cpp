@@ -1,14 +1,15 @@
 #include "NESCPU.h"
 
+#include <algorithm>
 #include <cassert>
+#include <iomanip>
 #include <sstream>
-#include <iostream> // @TODO Debug?
 
 
 std::string NESCPU::OpAsAsm(const std::string& opName, NESCPUOpAddrMode addrMode, u16 val)
 {
 	std::ostringstream oss;
-	oss << opName << " ";
+	oss << opName << std::uppercase << std::hex << std::setfill('0');
 
 	switch (addrMode)
 	{
@@ -17,52 +18,52 @@ std::string NESCPU::OpAsAsm(const std::string& opName, NESCPUOpAddrMode addrMode
 		break; // No operand in implied instructions.
 
 	case NESCPUOpAddrMode::ACCUMULATOR:
-		oss << "A";
+		oss << " A";
 		break;
 
 	case NESCPUOpAddrMode::IMMEDIATE:
-		oss << "#$" << std::hex << val;
+		oss << " #$" << std::setw(2) << val;
 		break;
 
 	case NESCPUOpAddrMode::ZEROPAGE:
-		oss << "$" << std::hex << val;
+		oss << " $" << std::setw(2) << val;
 		break;
 
 	case NESCPUOpAddrMode::ZEROPAGE_X:
-		oss << "$" << std::hex << val << ",X";
+		oss << " $" << std::setw(2) << val << ",X";
 		break;
 
 	case NESCPUOpAddrMode::ZEROPAGE_Y:
-		oss << "$" << std::hex << val << ",Y";
+		oss << " $" << std::setw(2) << val << ",Y";
 		break;
 
 	case NESCPUOpAddrMode::RELATIVE:
 	case NESCPUOpAddrMode::ABSOLUTE:
-		oss << "$" << std::hex << val;
+		oss << " $" << std::setw(4) << val;
 		break;
 
 	case NESCPUOpAddrMode::ABSOLUTE_X:
-		oss << "$" << std::hex << val << ",X";
+		oss << " $" << std::setw(4) << val << ",X";
 		break;
 
 	case NESCPUOpAddrMode::ABSOLUTE_Y:
-		oss << "$" << std::hex << val << ",Y";
+		oss << " $" << std::setw(4) << val << ",Y";
 		break;
 
 	case NESCPUOpAddrMode::INDIRECT:
-		oss << "($" << std::hex << val << ")";
+		oss << " ($" << std::setw(4) << val << ")";
 		break;
 
 	case NESCPUOpAddrMode::INDIRECT_X:
-		oss << "($" << std::hex << val << ",X)";
+		oss << " ($" << std::setw(2) << val << ",X)";
 		break;
 
 	case NESCPUOpAddrMode::INDIRECT_Y:
-		oss << "($" << std::hex << val << "),Y";
+		oss << " ($" << std::setw(2) << val << "),Y";
 		break;
 
 	default:
-		oss << "[???]";
+		oss << " [???]";
 		break;
 	}
 
@@ -70,51 +71,192 @@ std::string NESCPU::OpAsAsm(const std::string& opName, NESCPUOpAddrMode addrMode
 }
 
 
-NESCPUOpAddrMode NESCPU::GetOpAddrMode(u8 op)
+bool NESCPU::IsFlowChangingOp(u8 op)
 {
-	return opInfos_[op].addrMode;
+	switch (op)
+	{
+	case NES_OP_JMP_ABSOLUTE:
+	case NES_OP_JMP_INDIRECT:
+	case NES_OP_JSR_ABSOLUTE:
+	case NES_OP_RTS_IMPLIED:
+	case NES_OP_RTI_IMPLIED:
+	case NES_OP_KIL_IMPLIED1:
+	case NES_OP_KIL_IMPLIED2:
+	case NES_OP_KIL_IMPLIED3:
+	case NES_OP_KIL_IMPLIED4:
+	case NES_OP_KIL_IMPLIED5:
+	case NES_OP_KIL_IMPLIED6:
+	case NES_OP_KIL_IMPLIED7:
+	case NES_OP_KIL_IMPLIED8:
+	case NES_OP_KIL_IMPLIED9:
+	case NES_OP_KIL_IMPLIED10:
+	case NES_OP_KIL_IMPLIED11:
+	case NES_OP_KIL_IMPLIED12:
+		return true;
+
+	default:
+		// Branches and BRK.
+		return (opInfos_[op].addrMode == NESCPUOpAddrMode::RELATIVE || 
+			opInfos_[op].addrMode == NESCPUOpAddrMode::IMPLIED_BRK);
+	}
 }
 
 
-u16 NESCPU::GetOpSizeFromAddrMode(NESCPUOpAddrMode addrMode)
+bool NESCPU::IsIdleLoopOp(u8 op)
 {
-	switch (addrMode)
+	switch (op)
 	{
-		// 1 byte addressing modes.
-	case NESCPUOpAddrMode::ACCUMULATOR:
-	case NESCPUOpAddrMode::IMPLIED:
-		return 1;
-
-		// 2 byte addressing modes.
-	case NESCPUOpAddrMode::IMPLIED_BRK: // BRK has a padding byte.
-	case NESCPUOpAddrMode::IMMEDIATE:
-	case NESCPUOpAddrMode::RELATIVE:
-	case NESCPUOpAddrMode::ZEROPAGE:
-	case NESCPUOpAddrMode::ZEROPAGE_X:
-	case NESCPUOpAddrMode::ZEROPAGE_Y:
-	case NESCPUOpAddrMode::INDIRECT_X:
-	case NESCPUOpAddrMode::INDIRECT_Y:
-		return 2;
-
-		// 3 byte addressing modes.
-	case NESCPUOpAddrMode::ABSOLUTE:
-	case NESCPUOpAddrMode::ABSOLUTE_X:
-	case NESCPUOpAddrMode::ABSOLUTE_Y:
-	case NESCPUOpAddrMode::INDIRECT:
-		return 3;
+	// Loads.
+	case NES_OP_LDA_IMMEDIATE:
+	case NES_OP_LDA_ZEROPAGE:
+	case NES_OP_LDA_ZEROPAGE_X:
+	case NES_OP_LDA_ABSOLUTE:
+	case NES_OP_LDA_ABSOLUTE_X:
+	case NES_OP_LDA_ABSOLUTE_Y:
+	case NES_OP_LDA_INDIRECT_X:
+	case NES_OP_LDA_INDIRECT_Y:
+	case NES_OP_LDX_IMMEDIATE:
+	case NES_OP_LDX_ZEROPAGE:
+	case NES_OP_LDX_ZEROPAGE_Y:
+	case NES_OP_LDX_ABSOLUTE:
+	case NES_OP_LDX_ABSOLUTE_Y:
+	case NES_OP_LDY_IMMEDIATE:
+	case NES_OP_LDY_ZEROPAGE:
+	case NES_OP_LDY_ZEROPAGE_X:
+	case NES_OP_LDY_ABSOLUTE:
+	case NES_OP_LDY_ABSOLUTE_X:
+	case NES_OP_LAX_ZEROPAGE:
+	case NES_OP_LAX_ZEROPAGE_Y:
+	case NES_OP_LAX_ABSOLUTE:
+	case NES_OP_LAX_ABSOLUTE_Y:
+	case NES_OP_LAX_INDIRECT_X:
+	case NES_OP_LAX_INDIRECT_Y:
+	case NES_OP_LAX_IMMEDIATE:
+
+	// Comparisons and tests.
+	case NES_OP_BIT_ZEROPAGE:
+	case NES_OP_BIT_ABSOLUTE:
+	case NES_OP_CMP_IMMEDIATE:
+	case NES_OP_CMP_ZEROPAGE:
+	case NES_OP_CMP_ZEROPAGE_X:
+	case NES_OP_CMP_ABSOLUTE:
+	case NES_OP_CMP_ABSOLUTE_X:
+	case NES_OP_CMP_ABSOLUTE_Y:
+	case NES_OP_CMP_INDIRECT_X:
+	case NES_OP_CMP_INDIRECT_Y:
+	case NES_OP_CPX_IMMEDIATE:
+	case NES_OP_CPX_ZEROPAGE:
+	case NES_OP_CPX_ABSOLUTE:
+	case NES_OP_CPY_IMMEDIATE:
+	case NES_OP_CPY_ZEROPAGE:
+	case NES_OP_CPY_ABSOLUTE:
+
+	// Arithmetic and logic on the accumulator.
+	case NES_OP_AND_IMMEDIATE:
+	case NES_OP_AND_ZEROPAGE:
+	case NES_OP_AND_ZEROPAGE_X:
+	case NES_OP_AND_ABSOLUTE:
+	case NES_OP_AND_ABSOLUTE_X:
+	case NES_OP_AND_ABSOLUTE_Y:
+	case NES_OP_AND_INDIRECT_X:
+	case NES_OP_AND_INDIRECT_Y:
+	case NES_OP_ORA_IMMEDIATE:
+	case NES_OP_ORA_ZEROPAGE:
+	case NES_OP_ORA_ZEROPAGE_X:
+	case NES_OP_ORA_ABSOLUTE:
+	case NES_OP_ORA_ABSOLUTE_X:
+	case NES_OP_ORA_ABSOLUTE_Y:
+	case NES_OP_ORA_INDIRECT_X:
+	case NES_OP_ORA_INDIRECT_Y:
+	case NES_OP_EOR_IMMEDIATE:
+	case NES_OP_EOR_ZEROPAGE:
+	case NES_OP_EOR_ZEROPAGE_X:
+	case NES_OP_EOR_ABSOLUTE:
+	case NES_OP_EOR_ABSOLUTE_X:
+	case NES_OP_EOR_ABSOLUTE_Y:
+	case NES_OP_EOR_INDIRECT_X:
+	case NES_OP_EOR_INDIRECT_Y:
+	case NES_OP_ADC_IMMEDIATE:
+	case NES_OP_ADC_ZEROPAGE:
+	case NES_OP_ADC_ZEROPAGE_X:
+	case NES_OP_ADC_ABSOLUTE:
+	case NES_OP_ADC_ABSOLUTE_X:
+	case NES_OP_ADC_ABSOLUTE_Y:
+	case NES_OP_ADC_INDIRECT_X:
+	case NES_OP_ADC_INDIRECT_Y:
+	case NES_OP_SBC_IMMEDIATE:
+	case NES_OP_SBC_ZEROPAGE:
+	case NES_OP_SBC_ZEROPAGE_X:
+	case NES_OP_SBC_ABSOLUTE:
+	case NES_OP_SBC_ABSOLUTE_X:
+	case NES_OP_SBC_ABSOLUTE_Y:
+	case NES_OP_SBC_INDIRECT_X:
+	case NES_OP_SBC_INDIRECT_Y:
+	case NES_OP_SBC_U_IMMEDIATE:
+
+	// Register transfers.
+	case NES_OP_TAX_IMPLIED:
+	case NES_OP_TAY_IMPLIED:
+	case NES_OP_TXA_IMPLIED:
+	case NES_OP_TYA_IMPLIED:
+	case NES_OP_TSX_IMPLIED:
+
+	// Flag changes.
+	case NES_OP_CLC_IMPLIED:
+	case NES_OP_SEC_IMPLIED:
+	case NES_OP_CLV_IMPLIED:
+	case NES_OP_CLD_IMPLIED:
+	case NES_OP_SED_IMPLIED:
+
+	// NOPs, including the unofficial ones that read memory.
+	case NES_OP_NOP_IMPLIED:
+	case NES_OP_NOP_U_IMPLIED1:
+	case NES_OP_NOP_U_IMPLIED2:
+	case NES_OP_NOP_U_IMPLIED3:
+	case NES_OP_NOP_U_IMPLIED4:
+	case NES_OP_NOP_U_IMPLIED5:
+	case NES_OP_NOP_U_IMPLIED6:
+	case NES_OP_DOP_ZEROPAGE1:
+	case NES_OP_DOP_ZEROPAGE_X1:
+	case NES_OP_DOP_ZEROPAGE_X2:
+	case NES_OP_DOP_ZEROPAGE2:
+	case NES_OP_DOP_ZEROPAGE_X3:
+	case NES_OP_DOP_ZEROPAGE3:
+	case NES_OP_DOP_ZEROPAGE_X4:
+	case NES_OP_DOP_IMMEDIATE1:
+	case NES_OP_DOP_IMMEDIATE2:
+	case NES_OP_DOP_IMMEDIATE3:
+	case NES_OP_DOP_IMMEDIATE4:
+	case NES_OP_DOP_ZEROPAGE_X5:
+	case NES_OP_DOP_IMMEDIATE5:
+	case NES_OP_DOP_ZEROPAGE_X6:
+	case NES_OP_TOP_ABSOLUTE:
+	case NES_OP_TOP_ABSOLUTE_X1:
+	case NES_OP_TOP_ABSOLUTE_X2:
+	case NES_OP_TOP_ABSOLUTE_X3:
+	case NES_OP_TOP_ABSOLUTE_X4:
+	case NES_OP_TOP_ABSOLUTE_X5:
+	case NES_OP_TOP_ABSOLUTE_X6:
+		return true;
 
-		// Unknown addressing mode.
 	default:
-		assert("Unknown addressing mode supplied!" && false);
-		return 0;
+		return false;
 	}
 }
 
 
 NESCPU::NESCPU() :
 comm_(nullptr),
-elapsedCycles_(0)
+pageTable_(nullptr),
+trace_(nullptr),
+decodedBlocks_(NES_CPU_DECODED_BLOCK_CACHE_SIZE),
+currentBlock_(nullptr),
+currentBlockOpIndex_(0),
+elapsedCycles_(0),
+elapsedInstructions_(0),
+runTargetCycle_(0)
 {
+	pageWriteCounts_.fill(0);
 }
 
 
@@ -126,6 +268,7 @@ NESCPU::~NESCPU()
 void NESCPU::Initialize(INESCPUCommunicationsInterface& comm)
 {
 	comm_ = &comm;
+	pageTable_ = &comm.GetPageTable();
 }
 
 
@@ -152,9 +295,10 @@ void NESCPU::Power()
 {
 	assert(comm_ != nullptr);
 
-	elapsedCycles_ = 0;
+	elapsedCycles_ = elapsedInstructions_ = 0;
 
-	stallTicksLeft_ = 0;
+	// The elapsed cycle count has been reset, so the current instruction and stall must end on it too.
+	currentOp_.opEndCycle = stallEndCycle_ = 0;
 	isJammed_ = false;
 
 	// Schedule a reset.
@@ -166,271 +310,298 @@ void NESCPU::Power()
 	reg_.SetP(0x34); // I, B (and bit 5) are set on power.
 	reg_.A = reg_.X = reg_.Y = 0;
 
+	// A different ROM may have been loaded, so nothing that we've previously decoded or analyzed is valid.
+	ClearDecodedBlocks();
+	idleLoop_ = NESCPUIdleLoopInfo();
+
 	// @TODO Memory to power-up state!
 }
 
 
-void NESCPU::WriteOpResult(NESCPUOpAddrMode addrMode, u8 result)
+void NESCPU::ClearDecodedBlocks()
 {
-	u16 addr;
-	switch (addrMode)
-	{
-	case NESCPUOpAddrMode::ACCUMULATOR:
-		reg_.A = result; // Write to accumulator instead.
-		return;
+	for (auto& block : decodedBlocks_)
+		block.isValid = false;
 
-	case NESCPUOpAddrMode::INDIRECT_X:
-		addr = NESHelper::MemoryIndirectRead16(*comm_, (comm_->Read8(reg_.PC + 1) + reg_.X) & 0xFF);
-		break;
+	currentBlock_ = nullptr;
+}
 
-	case NESCPUOpAddrMode::INDIRECT_Y:
-		addr = NESHelper::MemoryIndirectRead16(*comm_, comm_->Read8(reg_.PC + 1)) + reg_.Y;
-		break;
 
-	case NESCPUOpAddrMode::ABSOLUTE:
-		addr = NESHelper::MemoryRead16(*comm_, reg_.PC + 1);
-		break;
+void NESCPU::DecodeBlock(NESCPUDecodedBlock& block, u16 addr, u32 tag)
+{
+	block.isValid = true;
+	block.startAddr = addr;
+	block.tag = tag;
+	block.opCount = 0;
 
-	case NESCPUOpAddrMode::ABSOLUTE_X:
-		addr = NESHelper::MemoryRead16(*comm_, reg_.PC + 1) + reg_.X;
-		break;
+	u32 opAddr = addr;
+	while (block.opCount < NES_CPU_DECODED_BLOCK_MAX_OPS)
+	{
+		const u8 op = ReadMemory8(opAddr);
+		const auto& opMapping = opInfos_[op];
+		const u16 opSize = opMapping.size;
 
-	case NESCPUOpAddrMode::ABSOLUTE_Y:
-		addr = NESHelper::MemoryRead16(*comm_, reg_.PC + 1) + reg_.Y;
-		break;
+		// Blocks cannot go outside of the page that they start in, as we only
+		// keep track of writes (for invalidating blocks) per page.
+		if (((opAddr + opSize - 1) >> 8) != (addr >> 8u))
+			break;
 
-	case NESCPUOpAddrMode::ZEROPAGE:
-		addr = comm_->Read8(reg_.PC + 1);
-		break;
+		auto& decodedOp = block.ops[block.opCount++];
+		decodedOp.execFunc = opExecFuncs_[op];
+		decodedOp.addr = opAddr;
+		decodedOp.op = op;
+		decodedOp.size = opMapping.size;
+		decodedOp.cycleCount = opMapping.cycleCount;
+		decodedOp.operand = 0;
+		if (opSize >= 2)
+			decodedOp.operand = ReadMemory8(opAddr + 1);
+		if (opSize >= 3)
+			decodedOp.operand |= ReadMemory8(opAddr + 2) << 8;
+
+		// End the block at any instruction that changes the flow of execution.
+		if (IsFlowChangingOp(op))
+			break;
 
-	case NESCPUOpAddrMode::ZEROPAGE_X:
-		addr = (comm_->Read8(reg_.PC + 1) + reg_.X) & 0xFF;
-		break;
+		opAddr += opSize;
+	}
+}
 
-	case NESCPUOpAddrMode::ZEROPAGE_Y:
-		addr = (comm_->Read8(reg_.PC + 1) + reg_.Y) & 0xFF;
-		break;
 
-	default:
-		// Unhandled addressing mode!
-		assert("Unknown addressing mode supplied to WriteOpResult()!" && false);
-		return;
-	}
+const NESCPUDecodedBlock* NESCPU::GetDecodedBlock(u16 addr)
+{
+	// Work out the tag that the block at addr should have.
+	// We only cache instructions from RAM, SRAM and PRG-ROM.
+	u32 tag;
+	if (addr < 0x2000 || (addr >= 0x6000 && addr < 0x8000))
+		tag = pageWriteCounts_[GetUnmirroredPage(addr)];
+	else if (addr >= 0x8000)
+		tag = static_cast<u32>(comm_->GetPRGBankIndex(addr));
+	else
+		return nullptr;
+
+	auto& block = decodedBlocks_[(addr ^ (tag * 0x2F1)) & (NES_CPU_DECODED_BLOCK_CACHE_SIZE - 1)];
+	if (!block.isValid || block.startAddr != addr || block.tag != tag)
+		DecodeBlock(block, addr, tag);
 
-	// Assume writing to main memory at addr.
-	comm_->Write8(addr, result);
+	return (block.opCount > 0 ? &block : nullptr);
 }
 
 
-NESCPUOpArgInfo NESCPU::ReadOpArgInfo(NESCPUOpAddrMode addrMode)
+const NESCPUDecodedOp* NESCPU::FetchDecodedOp()
 {
-	NESCPUOpArgInfo argInfo(addrMode);
+	// Continue executing the current block if the next instruction is the next one inside of the block.
+	// Blocks outside of PRG-ROM are only still valid if their page hasn't been written to since.
+	if (currentBlock_ != nullptr && currentBlockOpIndex_ < currentBlock_->opCount &&
+		currentBlock_->ops[currentBlockOpIndex_].addr == reg_.PC &&
+		(reg_.PC >= 0x8000 || currentBlock_->tag == pageWriteCounts_[GetUnmirroredPage(reg_.PC)]))
+		return &currentBlock_->ops[currentBlockOpIndex_++];
 
-	switch (argInfo.addrMode)
-	{
-	case NESCPUOpAddrMode::ACCUMULATOR: // Instruction will need to read the register.
-	case NESCPUOpAddrMode::IMPLIED: // No operands for implied addr modes.
-	case NESCPUOpAddrMode::IMPLIED_BRK:
-		break;
+	currentBlock_ = GetDecodedBlock(reg_.PC);
+	currentBlockOpIndex_ = 0;
 
-	case NESCPUOpAddrMode::IMMEDIATE:
-		argInfo.argAddr = reg_.PC + 1;
-		break;
+	return (currentBlock_ != nullptr ? &currentBlock_->ops[currentBlockOpIndex_++] : nullptr);
+}
 
-	case NESCPUOpAddrMode::RELATIVE:
-		// We add an extra 2 to the PC to cover the size of the rest of the instruction.
-		// The offset is a signed 2s complement number.
-		argInfo.argAddr = reg_.PC + 2 + static_cast<s8>(comm_->Read8(reg_.PC + 1));
-		break;
 
-	case NESCPUOpAddrMode::INDIRECT:
-		argInfo.argAddr = NESHelper::MemoryIndirectRead16(*comm_, NESHelper::MemoryRead16(*comm_, reg_.PC + 1));
-		break;
+void NESCPU::AnalyzeIdleLoop(u16 startAddr, u16 branchAddr)
+{
+	idleLoop_ = NESCPUIdleLoopInfo();
+	idleLoop_.isAnalyzed = true;
+	idleLoop_.startAddr = startAddr;
+	idleLoop_.branchAddr = branchAddr;
 
-	case NESCPUOpAddrMode::INDIRECT_X:
-		argInfo.argAddr = NESHelper::MemoryIndirectRead16(*comm_, (comm_->Read8(reg_.PC + 1) + reg_.X) & 0xFF);
-		break;
+	if (startAddr < 0x8000)
+	{
+		idleLoop_.startPageWriteCount = pageWriteCounts_[GetUnmirroredPage(startAddr)];
+		idleLoop_.branchPageWriteCount = pageWriteCounts_[GetUnmirroredPage(branchAddr)];
+	}
 
-	case NESCPUOpAddrMode::INDIRECT_Y:
-		argInfo.argAddr = NESHelper::MemoryIndirectRead16(*comm_, comm_->Read8(reg_.PC + 1));
-		argInfo.crossedPage = !NESHelper::IsInSamePage(argInfo.argAddr, argInfo.argAddr + reg_.Y);
-		argInfo.argAddr += reg_.Y;
-		break;
+	// Every op in the loop needs to be one that can be part of an idle loop, and only read from
+	// memory without side effects (anything mapped in the page table, or PPUSTATUS).
+	u16 addr = startAddr;
+	while (addr < branchAddr)
+	{
+		const u8 op = ReadMemory8(addr);
+		const auto& opInfo = opInfos_[op];
 
-	case NESCPUOpAddrMode::ABSOLUTE:
-		argInfo.argAddr = NESHelper::MemoryRead16(*comm_, reg_.PC + 1);
-		break;
+		if (pageTable_->GetReadPage(addr) == nullptr || pageTable_->GetReadPage(addr + opInfo.size - 1) == nullptr ||
+			!IsIdleLoopOp(op))
+			return;
 
-	case NESCPUOpAddrMode::ABSOLUTE_X:
-		argInfo.argAddr = NESHelper::MemoryRead16(*comm_, reg_.PC + 1);
-		argInfo.crossedPage = !NESHelper::IsInSamePage(argInfo.argAddr, argInfo.argAddr + reg_.X);
-		argInfo.argAddr += reg_.X;
-		break;
+		u16 operand = 0;
+		if (opInfo.size >= 2)
+			operand = ReadMemory8(addr + 1);
+		if (opInfo.size >= 3)
+			operand |= ReadMemory8(addr + 2) << 8;
 
-	case NESCPUOpAddrMode::ABSOLUTE_Y:
-		argInfo.argAddr = NESHelper::MemoryRead16(*comm_, reg_.PC + 1);
-		argInfo.crossedPage = !NESHelper::IsInSamePage(argInfo.argAddr, argInfo.argAddr + reg_.Y);
-		argInfo.argAddr += reg_.Y;
-		break;
+		switch (opInfo.addrMode)
+		{
+		case NESCPUOpAddrMode::IMPLIED:
+		case NESCPUOpAddrMode::IMMEDIATE:
+		case NESCPUOpAddrMode::ZEROPAGE: // Always reads from RAM.
+		case NESCPUOpAddrMode::ZEROPAGE_X:
+		case NESCPUOpAddrMode::ZEROPAGE_Y:
+			break;
 
-	case NESCPUOpAddrMode::ZEROPAGE:
-		argInfo.argAddr = comm_->Read8(reg_.PC + 1);
-		break;
+		case NESCPUOpAddrMode::ABSOLUTE:
+			if (operand >= 0x2000 && operand < 0x4000 && (operand & 7) == 2) // PPUSTATUS (or a mirror of it).
+				idleLoop_.readsPPUStatus = true;
+			else if (pageTable_->GetReadPage(operand) == nullptr)
+				return;
+			break;
 
-	case NESCPUOpAddrMode::ZEROPAGE_X:
-		argInfo.argAddr = (comm_->Read8(reg_.PC + 1) + reg_.X) & 0xFF;
-		break;
+		case NESCPUOpAddrMode::ABSOLUTE_X:
+		case NESCPUOpAddrMode::ABSOLUTE_Y:
+			if (pageTable_->GetReadPage(operand) == nullptr || pageTable_->GetReadPage(operand + 0xFF) == nullptr)
+				return;
+			break;
 
-	case NESCPUOpAddrMode::ZEROPAGE_Y:
-		argInfo.argAddr = (comm_->Read8(reg_.PC + 1) + reg_.Y) & 0xFF;
-		break;
+		default:
+			return;
+		}
 
-	default:
-		// Unhandled addressing mode!
-		assert("Unknown addressing mode supplied to ReadOpArgInfo()!" && false);
-		break;
+		addr += opInfo.size;
+		++idleLoop_.opCount;
 	}
 
-	return argInfo;
+	// The branch at the end of the loop is also executed every iteration.
+	++idleLoop_.opCount;
+	idleLoop_.isIdleCandidate = (addr == branchAddr);
 }
 
 
-//void NESCPU::FetchOp()
-//{
-//	// Fetch the amount of cycles not yet handled by the previous instruction.
-//	const auto unhandledCycles = (currentOp_.IsValid() ? currentOp_.opCyclesLeft : 0);
-//
-//	try
-//	{
-//		// Get the next opcode.
-//		currentOp_ = NESCPUExecutingOpInfo(comm_->Read8(reg_.PC));
-//	}
-//	catch (const NESMemoryException&)
-//	{
-//		throw NESCPUExecutionException("Could not read the next opcode for program execution.", reg_);
-//	}
-//
-//	// Get opcode mapping info.
-//	assert("Invalid opcode!" && opInfos_[currentOp_.op].opFunc != nullptr);
-//
-//	// Add the amount of unhandled cycles to the current instruction's cycle count.
-//	currentOp_.opCyclesLeft = opInfos_[currentOp_.op].cycleCount + unhandledCycles;
-//	currentOp_.opChangedPC = false;
-//}
-//
-//
-//void NESCPU::ExecuteOp()
-//{
-//	// Get arg info for executing instruction.
-//	auto argInfo = ReadOpArgInfo(opInfos_[currentOp_.op].addrMode);
-//
-//	u16 val;
-//	if (argInfo.addrMode == NESCPUOpAddrMode::IMMEDIATE)
-//		val = comm_->Read8(argInfo.argAddr);
-//	else if (argInfo.addrMode == NESCPUOpAddrMode::ACCUMULATOR)
-//		val = 0;
-//	else
-//		val = argInfo.argAddr;
-//	//
-//	//std::cout << "SP: $" << std::hex << +reg_.SP << ",  " <<  << std::endl;
-//	//std::cout << "stack: ";
-//	//for (u8 i = 0xFF; i >= 0 && i > reg_.SP; --i)
-//	//	std::cout << std::hex << +comm_->Read8(NES_CPU_STACK_START + i) << ", ";
-//	//std::cout << std::endl;
-//	//
-//	//static int a = 0;
-//	//if (a > 300000)
-//	//std::cout << "Cyc: " << elapsedCycles_ << ", Reg: " << reg_.ToString() << "\t Ins: " << OpAsAsm(opInfos_[currentOp_.op].opName, opInfos_[currentOp_.op].addrMode, val) << std::endl;
-//	//++a;
-//
-//	// Execute instruction.
-//	(this->*opInfos_[currentOp_.op].opFunc)(argInfo);
-//
-//	// Go to the next instruction if the CPU isn't now jammed...
-//	if (!currentOp_.opChangedPC && !isJammed_)
-//		reg_.PC += GetOpSizeFromAddrMode(opInfos_[currentOp_.op].addrMode);
-//}
+void NESCPU::CheckIdleLoop(u16 startAddr, u16 branchAddr)
+{
+	// Every iteration needs to be recorded while tracing, so none can be skipped.
+	if (trace_ != nullptr)
+		return;
 
+	// Analyze the loop if it's a different one to last time, or if it might have been modified.
+	if (!idleLoop_.isAnalyzed || idleLoop_.startAddr != startAddr || idleLoop_.branchAddr != branchAddr ||
+		(startAddr < 0x8000 && (idleLoop_.startPageWriteCount != pageWriteCounts_[GetUnmirroredPage(startAddr)] ||
+		idleLoop_.branchPageWriteCount != pageWriteCounts_[GetUnmirroredPage(branchAddr)])))
+		AnalyzeIdleLoop(startAddr, branchAddr);
 
-void NESCPU::ExecuteNextOp()
-{
-	if (isJammed_ || stallTicksLeft_ > 0)
+	if (!idleLoop_.isIdleCandidate)
+		return;
+
+	// Check if this iteration left the CPU in the same state as the last one did.
+	// If the loop reads PPUSTATUS, it also needs to have returned the same value as last time.
+	const u64 iterationLength = elapsedCycles_ - idleLoop_.lastIterationCycle;
+	const bool isMatchingIteration = (reg_ == idleLoop_.lastIterationReg && iterationLength == idleLoop_.lastIterationLength &&
+		(!idleLoop_.readsPPUStatus || elapsedCycles_ <= idleLoop_.ppuStatusStableUntilCycle));
+
+	idleLoop_.matchedIterations = (isMatchingIteration ? idleLoop_.matchedIterations + 1 : 0);
+	idleLoop_.lastIterationReg = reg_;
+	idleLoop_.lastIterationCycle = elapsedCycles_;
+	idleLoop_.lastIterationLength = iterationLength;
+
+	if (idleLoop_.readsPPUStatus)
+		idleLoop_.ppuStatusStableUntilCycle = comm_->GetPPUStatusStableUntilCycle();
+
+	// We need two matching iterations in a row, as the first may have seen a
+	// different value of PPUSTATUS before it was cleared by reading it.
+	// Interrupts would also run code outside of the loop.
+	if (idleLoop_.matchedIterations < 2 || nextInt_ != NESCPUInterruptType::NONE || intReset_ || intNmi_ || intIrq_)
+		return;
+
+	// Skip over every upcoming iteration whose branch would start executing before the end of the current run,
+	// and whose reads of PPUSTATUS would all happen before it could change.
+	if (runTargetCycle_ <= elapsedCycles_)
 		return;
 
-	try
+	u64 skipIterations = (runTargetCycle_ - elapsedCycles_ - 1) / iterationLength;
+	if (idleLoop_.readsPPUStatus)
 	{
-		// Get the next opcode.
-		currentOp_ = NESCPUExecutingOpInfo(comm_->Read8(reg_.PC));
+		skipIterations = (idleLoop_.ppuStatusStableUntilCycle > elapsedCycles_ ?
+			std::min(skipIterations, (idleLoop_.ppuStatusStableUntilCycle - elapsedCycles_) / iterationLength) : 0);
 	}
-	catch (const NESMemoryException&)
+
+	// The branch that we're executing finishes the same amount of cycles after the skipped iterations.
+	elapsedCycles_ += skipIterations * iterationLength;
+	elapsedInstructions_ += skipIterations * idleLoop_.opCount;
+	currentOp_.opEndCycle += skipIterations * iterationLength;
+	idleLoop_.lastIterationCycle = elapsedCycles_;
+}
+
+
+void NESCPU::ExecuteNextOp()
+{
+	if (isJammed_ || IsStalled())
+		return;
+
+	const NESCPUDecodedOp* decodedOp = FetchDecodedOp();
+
+	NESOpExecFuncPointer execFunc;
+	u16 opSize, operand;
+	if (decodedOp != nullptr)
 	{
-		throw NESCPUExecutionException("Could not read the next opcode for program execution.", reg_);
-	}
+		currentOp_ = NESCPUExecutingOpInfo(decodedOp->op);
+		currentOp_.opEndCycle = elapsedCycles_ + decodedOp->cycleCount;
 
-	// @TODO Debug!
-	static bool testDone = false;
-	if (comm_->Read8(0x6000) != 0x80 &&
-		comm_->Read8(0x6001) == 0xDE &&
-		comm_->Read8(0x6002) == 0xB0 &&
-		comm_->Read8(0x6003) == 0x61 &&
-		!testDone)
+		execFunc = decodedOp->execFunc;
+		opSize = decodedOp->size;
+		operand = decodedOp->operand;
+	}
+	else
 	{
-		testDone = true;
-		std::cout << "Test status: $" << std::hex << +comm_->Read8(0x6000) << std::endl;
-		std::cout << "Message: " << std::endl;
-		for (u16 i = 0x6004;; ++i)
+		// The instruction isn't cachable - decode it now instead.
+		try
 		{
-			const u8 c = comm_->Read8(i);
-			if (c == 0)
-				break;
-
-			std::cout << c;
+			// Get the next opcode.
+			currentOp_ = NESCPUExecutingOpInfo(ReadMemory8(reg_.PC));
+		}
+		catch (const NESMemoryException&)
+		{
+			throw NESCPUExecutionException("Could not read the next opcode for program execution.", reg_);
 		}
-		std::cout << std::endl;
-	}
-	else if (comm_->Read8(0x6000) == 0x81)
-		intReset_ = true;
 
-	// Get opcode mapping info.
-	const auto& opMapping = opInfos_[currentOp_.op];
-	assert("Invalid opcode!" && opMapping.opFunc != nullptr);
+		// Get opcode mapping info.
+		const auto& opMapping = opInfos_[currentOp_.op];
+		currentOp_.opEndCycle = elapsedCycles_ + opMapping.cycleCount;
+
+		execFunc = opExecFuncs_[currentOp_.op];
+		opSize = opMapping.size;
+		operand = 0;
+		if (opSize >= 2)
+			operand = ReadMemory8(reg_.PC + 1);
+		if (opSize >= 3)
+			operand |= ReadMemory8(reg_.PC + 2) << 8;
+	}
 
-	auto argInfo = ReadOpArgInfo(opMapping.addrMode);
-	currentOp_.opCyclesLeft = opMapping.cycleCount;
 	currentOp_.opChangedPC = false;
+	++elapsedInstructions_;
 
-	u16 val;
-	if (argInfo.addrMode == NESCPUOpAddrMode::IMMEDIATE)
-		val = comm_->Read8(argInfo.argAddr);
-	else if (argInfo.addrMode == NESCPUOpAddrMode::ACCUMULATOR)
-		val = 0;
-	else
-		val = argInfo.argAddr;
-	//
-	//std::cout << "SP: $" << std::hex << +reg_.SP << ",  " <<  << std::endl;
-	//std::cout << "stack: ";
-	//for (u8 i = 0xFF; i >= 0 && i > reg_.SP; --i)
-	//	std::cout << std::hex << +comm_->Read8(NES_CPU_STACK_START + i) << ", ";
-	//std::cout << std::endl;
-	//
-	//if (elapsedCycles_ >= 29000)
-	//{
-	//	std::cout << "C: " << elapsedCycles_ << "|" << reg_.ToString() << "\t I: " << OpAsAsm(opMapping.opName, opMapping.addrMode, val) << std::endl;
-	//}
-	//
-	//static bool a = false;
-	//if (reg_.PC == 0xc50a || a)
-	//{
-	//	std::cout << std::endl;
-	//	a = true;
-	//}
+	if (trace_ != nullptr)
+		RecordTrace(opSize, operand);
 
 	// Execute instruction.
-	(this->*opMapping.opFunc)(argInfo);
+	execFunc(*this, operand);
 
 	// Go to the next instruction if the CPU isn't now jammed...
 	if (!currentOp_.opChangedPC && !isJammed_)
-		reg_.PC += GetOpSizeFromAddrMode(opMapping.addrMode);
+		reg_.PC += opSize;
+}
+
+
+void NESCPU::RecordTrace(u16 opSize, u16 operand)
+{
+	auto& record = trace_->Push();
+
+	record.cpuCycle = elapsedCycles_;
+	record.PC = reg_.PC;
+	comm_->GetPPUPosition(record.ppuScanline, record.ppuCycle);
+
+	record.opBytes[0] = currentOp_.op;
+	record.opBytes[1] = (operand & 0xFF);
+	record.opBytes[2] = (operand >> 8);
+	record.opSize = static_cast<u8>(opSize);
+
+	record.A = reg_.A;
+	record.X = reg_.X;
+	record.Y = reg_.Y;
+	record.P = reg_.GetP();
+	record.SP = reg_.SP;
 }
 
 
@@ -441,11 +612,11 @@ NESCPUInterruptType NESCPU::PollInterrupts()
 	// Determine which interrupt to schedule depending on priority.
 	if (intReset_)
 		nextInt = NESCPUInterruptType::RESET;
-	else if (!isJammed_ && stallTicksLeft_ == 0)
+	else if (!isJammed_ && !IsStalled())
 	{
 		if (intNmi_) // @TODO: Check for NMI Edge!
 			nextInt = NESCPUInterruptType::NMI;
-		else if (intIrq_ && !NESHelper::IsBitSet(reg_.GetP(), NES_CPU_REG_P_I_BIT))
+		else if (intIrq_ && !reg_.GetI())
 			nextInt = NESCPUInterruptType::IRQ;
 	}
 
@@ -475,26 +646,29 @@ NESCPUInterruptType NESCPU::HandleInterrupts()
 		switch (nextInt_)
 		{
 		case NESCPUInterruptType::RESET:
-			UpdateRegPC(NESHelper::MemoryRead16(*comm_, 0xFFFC));
+			UpdateRegPC(ReadMemory16(0xFFFC));
 			intReset_ = false;
 			break;
 
 		case NESCPUInterruptType::NMI:
-			UpdateRegPC(NESHelper::MemoryRead16(*comm_, 0xFFFA));
+			UpdateRegPC(ReadMemory16(0xFFFA));
 			intNmi_ = false;
 			break;
 
 		case NESCPUInterruptType::IRQ:
-			UpdateRegPC(NESHelper::MemoryRead16(*comm_, 0xFFFE));
+			UpdateRegPC(ReadMemory16(0xFFFE));
 			intIrq_ = false;
 			break;
 		}
 
+		// The interrupt has stopped any idle loop we were in.
+		idleLoop_.matchedIterations = 0;
+
 		// We interrupted, so make sure the interupt disable flag is set.
-		reg_.SetP(NESHelper::SetBit(reg_.GetP(), NES_CPU_REG_P_I_BIT));
+		reg_.SetI(true);
 
 		// Interrupts take 7 cycles to execute.
-		OpAddCycles(7);
+		currentOp_.opEndCycle = elapsedCycles_ + 7;
 	}
 
 	nextInt_ = NESCPUInterruptType::NONE;
@@ -506,9 +680,9 @@ void NESCPU::Tick()
 {
 	assert(comm_ != nullptr);
 
-	if (!isJammed_ && stallTicksLeft_ == 0)
+	if (!isJammed_ && !IsStalled())
 	{
-		if (currentOp_.opCyclesLeft == 0)
+		if (elapsedCycles_ >= currentOp_.opEndCycle)
 		{
 			if (nextInt_ != NESCPUInterruptType::NONE)
 				HandleInterrupts();
@@ -521,8 +695,29 @@ void NESCPU::Tick()
 	}
 
 	++elapsedCycles_;
-	if (currentOp_.opCyclesLeft != 0)
-		--currentOp_.opCyclesLeft;
-	if (stallTicksLeft_ != 0)
-		--stallTicksLeft_;
+}
+
+void NESCPU::RunUntil(u64 targetCycle)
+{
+	assert(comm_ != nullptr);
+
+	runTargetCycle_ = targetCycle;
+	while (elapsedCycles_ < runTargetCycle_)
+	{
+		// Work out how many of the upcoming ticks would do nothing but wait for
+		// the current instruction or the stall to end (or anything if we're jammed).
+		const u64 cyclesLeft = runTargetCycle_ - elapsedCycles_;
+		const u64 busyUntilCycle = std::max(currentOp_.opEndCycle, stallEndCycle_);
+		const u64 idleCycles = (isJammed_ ? cyclesLeft :
+			(busyUntilCycle > elapsedCycles_ ? std::min(busyUntilCycle - elapsedCycles_, cyclesLeft) : 0));
+
+		if (idleCycles == 0)
+		{
+			Tick();
+			continue;
+		}
+
+		// Skip over the idle cycles in one go.
+		elapsedCycles_ += idleCycles;
+	}
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include <sstream>
+#include <vector>
 
 #include "NESException.h"
 #include "NESTypes.h"
@@ -9,6 +12,7 @@
 #include "NESCPUOpConstants.h"
 #include "NESMemoryConstants.h"
 #include "NESMemory.h"
+#include "NESCPUTrace.h"
 
 typedef NESMemory<0x800> NESMemCPURAM;
 
@@ -36,18 +40,57 @@ struct NESCPURegisters
 
 	NESCPURegisters() :
 		PC(0), SP(0),
-		P_(0x20),
 		A(0), X(0), Y(0)
-	{ }
+	{
+		SetP(0x20);
+	}
 
 	/**
 	* Sets the current value of Processor Status (P) to val.
 	* Makes sure that bit 5 of P is always 1, regardless of val.
 	*/
-	inline void SetP(u8 val) { P_ = val | 0x20; }
+	inline void SetP(u8 val)
+	{
+		P_ = val | 0x20;
+		nResult_ = val;
+		zResult_ = (NESHelper::IsBitSet(val, NES_CPU_REG_P_Z_BIT) ? 0 : 1);
+		carry_ = val & 1;
+		overflowResult_ = static_cast<u8>(val << 1);
+	}
 
 	/* Gets the current value of Processor Status (P) flag. */
-	inline u8 GetP() const { return P_; }
+	inline u8 GetP() const
+	{
+		return (P_ & 0x3C) | (nResult_ & 0x80) | ((overflowResult_ & 0x80) >> 1) | (zResult_ == 0 ? 2 : 0) | carry_;
+	}
+
+	/* Gets the values of the individual flags in P. */
+	inline bool GetN() const { return ((nResult_ & 0x80) != 0); }
+	inline bool GetV() const { return ((overflowResult_ & 0x80) != 0); }
+	inline bool GetI() const { return NESHelper::IsBitSet(P_, NES_CPU_REG_P_I_BIT); }
+	inline bool GetZ() const { return (zResult_ == 0); }
+	inline bool GetC() const { return (carry_ != 0); }
+
+	/**
+	* Sets the values of the individual flags in P.
+	* N, Z and V are set from the result they're based on, and are only worked out when they're needed.
+	*/
+	inline void SetNResult(u8 result) { nResult_ = result; } // N is set to bit 7 of result.
+	inline void SetZResult(u8 result) { zResult_ = result; } // Z is set if result is 0.
+	inline void SetNZResult(u8 result) { nResult_ = zResult_ = result; }
+	inline void SetVResult(u8 result) { overflowResult_ = result; } // V is set to bit 7 of result.
+	inline void SetV(bool isSet) { overflowResult_ = (isSet ? 0x80 : 0); }
+	inline void SetI(bool isSet) { NESHelper::EditRefBit(P_, NES_CPU_REG_P_I_BIT, isSet); }
+	inline void SetD(bool isSet) { NESHelper::EditRefBit(P_, NES_CPU_REG_P_D_BIT, isSet); }
+	inline void SetC(bool isSet) { carry_ = (isSet ? 1 : 0); }
+
+	/**
+	* Whether or not every register has the same value as in other.
+	*/
+	inline bool operator==(const NESCPURegisters& other) const
+	{
+		return (PC == other.PC && SP == other.SP && A == other.A && X == other.X && Y == other.Y && GetP() == other.GetP());
+	}
 
 	/**
 	* Returns a string representation of the value of the registers.
@@ -57,13 +100,17 @@ struct NESCPURegisters
 		std::ostringstream oss;
 		oss << "PC $" << std::hex << PC << ", SP $" << std::hex << +SP
 			<< ", A $" << std::hex << +A << ", X $" << std::hex << +X << ", Y $" << std::hex << +Y
-			<< ", P $" << std::hex << +P_;
+			<< ", P $" << std::hex << +GetP();
 		return oss.str();
 	}
 
 private:
-	/* Processor Status (P) */
+	/* Processor Status (P) - only holds bits 2 - 5 (I, D, B and bit 5), the rest are evaluated lazily. */
 	u8 P_;
+
+	/* The results that N, Z and V are based on, and the value of C (0 or 1). */
+	u8 nResult_, zResult_, overflowResult_;
+	u8 carry_;
 };
 
 /**
@@ -145,23 +192,38 @@ class NESCPU;
 // Typedef for a basic opcode executing function.
 typedef void (NESCPU::*NESOpFuncPointer)(NESCPUOpArgInfo& argInfo);
 
+// Typedef for a function that executes a specific opcode (with its addressing mode resolved) given its operand.
+// A plain function pointer is used as it's half the size of a pointer to a member function.
+typedef void (*NESOpExecFuncPointer)(NESCPU& cpu, u16 operand);
+
+/**
+* Returns the size in bytes of an instruction using the specified addressing mode.
+*/
+inline constexpr u8 GetNESCPUOpSize(NESCPUOpAddrMode addrMode)
+{
+	return (addrMode == NESCPUOpAddrMode::ACCUMULATOR || addrMode == NESCPUOpAddrMode::IMPLIED) ? 1 :
+		(addrMode == NESCPUOpAddrMode::ABSOLUTE || addrMode == NESCPUOpAddrMode::ABSOLUTE_X ||
+		 addrMode == NESCPUOpAddrMode::ABSOLUTE_Y || addrMode == NESCPUOpAddrMode::INDIRECT) ? 3 :
+		2; // BRK has a padding byte, so is also 2 bytes.
+}
+
 /**
-* Struct containing opcode function mapping info.
+* Struct containing opcode info.
 */
 struct NESCPUOpInfo
 {
-	const std::string opName;
-	const bool isOfficialOp;
-	const NESOpFuncPointer opFunc;
-	const NESCPUOpAddrMode addrMode;
-	const unsigned int cycleCount;
+	const char* opName;
+	bool isOfficialOp;
+	NESCPUOpAddrMode addrMode;
+	u8 cycleCount;
+	u8 size;
 
-	NESCPUOpInfo(const std::string& opName, bool isOfficialOp, NESOpFuncPointer opFunc, NESCPUOpAddrMode addrMode, unsigned int cycleCount) :
+	constexpr NESCPUOpInfo(const char* opName, bool isOfficialOp, NESCPUOpAddrMode addrMode, u8 cycleCount) :
 		opName(opName),
 		isOfficialOp(isOfficialOp),
-		opFunc(opFunc),
 		addrMode(addrMode),
-		cycleCount(cycleCount)
+		cycleCount(cycleCount),
+		size(GetNESCPUOpSize(addrMode))
 	{ }
 };
 
@@ -171,19 +233,19 @@ struct NESCPUOpInfo
 struct NESCPUExecutingOpInfo
 {
 	u8 op;
-	unsigned int opCyclesLeft;
+	u64 opEndCycle; // The elapsed CPU cycle count that the instruction finishes executing at.
 	bool opChangedPC;
 
 	NESCPUExecutingOpInfo() :
 		isValid_(false),
-		op(NES_OP_KIL_IMPLIED1), opCyclesLeft(0),
+		op(NES_OP_KIL_IMPLIED1), opEndCycle(0),
 		opChangedPC(false)
 	{ }
 
 	NESCPUExecutingOpInfo(u8 op) :
 		isValid_(true),
 		op(op),
-		opCyclesLeft(0),
+		opEndCycle(0),
 		opChangedPC(false)
 	{ }
 
@@ -199,6 +261,99 @@ private:
 /* Address in memory where the CPU stack begins. */
 #define NES_CPU_STACK_START 0x0100
 
+/* The max amount of instructions stored inside of a single decoded block. */
+#define NES_CPU_DECODED_BLOCK_MAX_OPS 16
+
+/* The amount of decoded blocks that can be cached by the CPU. Must be a power of 2. */
+#define NES_CPU_DECODED_BLOCK_CACHE_SIZE 0x400
+
+/**
+* Struct containing a predecoded instruction.
+*/
+struct NESCPUDecodedOp
+{
+	NESOpExecFuncPointer execFunc;
+	u16 addr, operand;
+	u8 op, size, cycleCount;
+
+	NESCPUDecodedOp() :
+		execFunc(nullptr),
+		addr(0), operand(0),
+		op(0), size(0), cycleCount(0)
+	{ }
+};
+
+/**
+* Struct containing a run of predecoded instructions, starting at startAddr and ending
+* at the first instruction that changes the flow of execution, or at the end of the memory page.
+* Decoded blocks are tagged with the PRG-ROM bank index that they were decoded from if they are inside
+* of PRG-ROM, or with the write count of their page at the time of decoding if they are inside of RAM / SRAM.
+*/
+struct NESCPUDecodedBlock
+{
+	bool isValid;
+	u16 startAddr;
+	u32 tag;
+
+	u8 opCount;
+	std::array<NESCPUDecodedOp, NES_CPU_DECODED_BLOCK_MAX_OPS> ops;
+
+	NESCPUDecodedBlock() :
+		isValid(false),
+		startAddr(0),
+		tag(0),
+		opCount(0)
+	{ }
+};
+
+/* The max size of a loop in bytes (excluding the branch at its end) that can be detected as an idle loop. */
+#define NES_CPU_IDLE_LOOP_MAX_SIZE 16
+
+/**
+* Info about the loop that was most recently branched back to, used for detecting idle loops.
+* An idle loop is a short loop that only reads memory without side effects (such as a loop polling
+* PPUSTATUS or a RAM flag that's set by the NMI handler) and leaves the CPU in the same state after every iteration.
+*/
+struct NESCPUIdleLoopInfo
+{
+	// Whether or not the loop has been analyzed, and whether or not it only contains ops that can be part of an idle loop.
+	bool isAnalyzed, isIdleCandidate;
+
+	// Whether or not the loop reads PPUSTATUS.
+	bool readsPPUStatus;
+
+	// The start of the loop, and the addr of the backwards branch at the end of it.
+	u16 startAddr, branchAddr;
+
+	// The amount of instructions executed by every iteration, including the branch.
+	unsigned int opCount;
+
+	// Write counts of the pages of the loop when it was analyzed (if it isn't in PRG-ROM).
+	u32 startPageWriteCount, branchPageWriteCount;
+
+	// Registers after the last iteration, the cycle that the last iteration's branch was executed on,
+	// and the amount of cycles that the last iteration took.
+	NESCPURegisters lastIterationReg;
+	u64 lastIterationCycle, lastIterationLength;
+
+	// The CPU cycle up until which PPUSTATUS was known not to change as of the last iteration.
+	u64 ppuStatusStableUntilCycle;
+
+	// Amount of iterations in a row that have left the CPU in the same state.
+	unsigned int matchedIterations;
+
+	NESCPUIdleLoopInfo() :
+		isAnalyzed(false), isIdleCandidate(false),
+		readsPPUStatus(false),
+		startAddr(0), branchAddr(0),
+		opCount(0),
+		startPageWriteCount(0), branchPageWriteCount(0),
+		lastIterationCycle(0), lastIterationLength(0),
+		ppuStatusStableUntilCycle(0),
+		matchedIterations(0)
+	{ }
+};
+
 /**
 * Interface for allowing the CPU to communicate with other devices.
 */
@@ -206,6 +361,27 @@ class INESCPUCommunicationsInterface : public INESMemoryInterface
 {
 public:
 	virtual ~INESCPUCommunicationsInterface() { }
+
+	/**
+	* Gets the index of the PRG-ROM bank that is currently mapped at addr ($8000 - $FFFF).
+	*/
+	virtual std::size_t GetPRGBankIndex(u16 addr) const = 0;
+
+	/**
+	* Gets the page table of the memory that the CPU can access directly instead of calling Read8() and Write8().
+	*/
+	virtual const NESMemoryPageTable& GetPageTable() const = 0;
+
+	/**
+	* Gets the CPU cycle up until which reading PPUSTATUS is guaranteed to return the same value
+	* as the last read of it did (assuming nothing else writes to the PPU beforehand).
+	*/
+	virtual u64 GetPPUStatusStableUntilCycle() = 0;
+
+	/**
+	* Gets the scanline and cycle that the PPU is on at the CPU's current cycle.
+	*/
+	virtual void GetPPUPosition(u16& scanline, u16& cycle) const = 0;
 };
 
 /**
@@ -240,10 +416,28 @@ public:
 	*/
 	void Tick();
 
+	/**
+	* Runs the CPU until its elapsed cycle count reaches targetCycle, or until EndRun() is called.
+	* Cycles where the CPU is only waiting on the current instruction, a stall or a jam are
+	* skipped over in bulk instead of being ticked individually.
+	*/
+	void RunUntil(u64 targetCycle);
+
+	/**
+	* Ends the current call to RunUntil() once the CPU cycle currently being ticked has finished.
+	* Used when another device's state has changed in a way that the CPU's run target
+	* may no longer be valid.
+	*/
+	inline void EndRun() { runTargetCycle_ = elapsedCycles_ + 1; }
+
 	/**
 	* Reads 8-bits from CPU memory at a specified address in CPU memory.
 	*/
-	inline u8 ReadMemory8(u16 addr) const { return comm_->Read8(addr); };
+	inline u8 ReadMemory8(u16 addr) const
+	{
+		const auto page = pageTable_->GetReadPage(addr);
+		return (page != nullptr ? page[addr & 0xFF] : comm_->Read8(addr));
+	}
 
 	/**
 	* Whether or not the CPU is jammed.
@@ -253,84 +447,313 @@ public:
 	/**
 	* Sets the CPU to be stalled for an additional amount of ticks.
 	*/
-	inline void StallFor(unsigned int ticks) { stallTicksLeft_ += ticks; }
+	inline void StallFor(unsigned int ticks) { stallEndCycle_ = std::max(stallEndCycle_, elapsedCycles_) + ticks; }
 
 	/**
 	* Whether or not the CPU is currently stalled.
 	*/
-	inline bool IsStalled() const { return (stallTicksLeft_ > 0); }
+	inline bool IsStalled() const { return (elapsedCycles_ < stallEndCycle_); }
 
 	/**
 	* Gets the amount of elapsed CPU cycles since power.
 	*/
-	inline unsigned int GetElapsedCycles() const { return elapsedCycles_; }
+	inline u64 GetElapsedCycles() const { return elapsedCycles_; }
+
+	/**
+	* Gets the amount of instructions executed since power, including those of skipped idle loop iterations.
+	*/
+	inline u64 GetElapsedInstructions() const { return elapsedInstructions_; }
 
 	/**
 	* Returns a const reference to the current CPU registers.
 	*/
 	inline const NESCPURegisters& GetRegisters() const { return reg_; }
 
-private:
-	// Contains opcode info.
-	static std::array<NESCPUOpInfo, 0x100> opInfos_;
-
 	/**
-	* Registers an official opcode mapping.
+	* Overwrites the current CPU registers.
+	* Used to start execution in a known state, such as for nestest's automation mode.
 	*/
-	static void RegisterOp(const std::string& opName, u8 op, bool isOfficialOp, NESOpFuncPointer opFunc, NESCPUOpAddrMode addrMode, int cycleCount);
+	inline void SetRegisters(const NESCPURegisters& reg) { reg_ = reg; }
 
 	/**
-	* Gets the addressing mode of the specified opcode.
+	* Sets the buffer that every executed instruction is recorded to. Pass nullptr to stop tracing.
+	* Idle loops aren't skipped over while tracing, so that none of their iterations are missing from the trace.
 	*/
-	static NESCPUOpAddrMode GetOpAddrMode(u8 op);
+	inline void SetTraceBuffer(NESCPUTraceBuffer* trace) { trace_ = trace; }
 
 	/**
-	* Returns the size of the opcode's addressing mode in bytes.
+	* Gets the info of the specified opcode.
 	*/
-	static u16 GetOpSizeFromAddrMode(NESCPUOpAddrMode addrMode);
+	inline static const NESCPUOpInfo& GetOpInfo(u8 op) { return opInfos_[op]; }
 
 	/**
 	* Return an assembly string representation of an instruction.
+	* For relative addressing, val should be the address that is branched to.
 	*/
 	static std::string OpAsAsm(const std::string& opName, NESCPUOpAddrMode addrMode, u16 val);
 
+private:
+	// Contains opcode info.
+	static const std::array<NESCPUOpInfo, 0x100> opInfos_;
+
+	// Jump table of the functions that execute each opcode.
+	static const std::array<NESOpExecFuncPointer, 0x100> opExecFuncs_;
+
+	/**
+	* Executes an op with its addressing mode resolved at compile time.
+	*/
+	template <NESOpFuncPointer opFunc, NESCPUOpAddrMode addrMode>
+	static void ExecuteOp(NESCPU& cpu, u16 operand)
+	{
+		auto argInfo = cpu.ReadOpArgInfo<addrMode>(operand);
+		(cpu.*opFunc)(argInfo);
+	}
+
+	/**
+	* Returns whether or not the specified op changes the flow of execution.
+	*/
+	static bool IsFlowChangingOp(u8 op);
+
+	/**
+	* Returns whether or not the specified op can be part of an idle loop.
+	* These ops only read from memory, and only write to registers that would be the same after every iteration of an idle loop.
+	*/
+	static bool IsIdleLoopOp(u8 op);
+
 	INESCPUCommunicationsInterface* comm_;
+	const NESMemoryPageTable* pageTable_;
+	NESCPUTraceBuffer* trace_;
 
 	NESCPURegisters reg_;
 	NESCPUExecutingOpInfo currentOp_;
 
+	// Cache of decoded blocks, and the block (and the index of the op inside of it) that we're currently executing.
+	std::vector<NESCPUDecodedBlock> decodedBlocks_;
+	const NESCPUDecodedBlock* currentBlock_;
+	u8 currentBlockOpIndex_;
+
+	// The loop that was most recently branched back to.
+	NESCPUIdleLoopInfo idleLoop_;
+
+	// Amount of writes made to each page of RAM and SRAM (used to invalidate the blocks decoded from them).
+	// RAM mirrors use the write counts of pages $00 - $07.
+	std::array<u32, 0x100> pageWriteCounts_;
+
 	NESCPUInterruptType nextInt_;
 	bool intReset_, intNmi_, intIrq_;
 
 	bool isJammed_;
-	unsigned int stallTicksLeft_;
 
-	unsigned int elapsedCycles_;
+	// The elapsed cycle count that the CPU is stalled until.
+	u64 stallEndCycle_;
+
+	u64 elapsedCycles_, elapsedInstructions_;
+
+	// The elapsed cycle count that the current call to RunUntil() will run the CPU until.
+	u64 runTargetCycle_;
+
+	/**
+	* Reads 16-bits (little-endian) from CPU memory at a specified address.
+	*/
+	inline u16 ReadMemory16(u16 addr) const { return NESHelper::ConvertTo16(ReadMemory8(addr + 1), ReadMemory8(addr)); }
+
+	/**
+	* Reads 16-bits (little-endian) from CPU memory while accounting for the 6502 indirect addressing bug.
+	*/
+	inline u16 ReadMemoryIndirect16(u16 addr) const
+	{
+		return NESHelper::ConvertTo16(ReadMemory8((addr & 0xFF00) | ((addr + 1) & 0xFF)), ReadMemory8(addr));
+	}
+
+	/**
+	* Gets the page that addr would be in after accounting for RAM mirroring.
+	*/
+	inline static u8 GetUnmirroredPage(u16 addr) { return (addr < 0x2000 ? (addr & 0x7FF) : addr) >> 8; }
+
+	/**
+	* Writes 8-bits to CPU memory at a specified address.
+	* Keeps track of writes that could invalidate the decoded block cache.
+	*/
+	inline void WriteMemory8(u16 addr, u8 val)
+	{
+		const auto page = pageTable_->GetWritePage(addr);
+
+		if (page != nullptr)
+			page[addr & 0xFF] = val;
+		else
+			comm_->Write8(addr, val);
+
+		if (addr >= 0x8000)
+		{
+			// Writes to the mapper may have switched PRG-ROM banks, so stop
+			// executing from the current block (it will be looked up again),
+			// and re-analyze the last loop if it's executed again.
+			currentBlock_ = nullptr;
+			idleLoop_.isAnalyzed = false;
+		}
+		else
+			++pageWriteCounts_[GetUnmirroredPage(addr)];
+	}
+
+	/**
+	* Analyzes the loop from startAddr to the backwards branch at branchAddr to see if it could be an idle loop.
+	*/
+	void AnalyzeIdleLoop(u16 startAddr, u16 branchAddr);
+
+	/**
+	* Called after a short backwards branch at branchAddr to startAddr was taken.
+	* If the loop is an idle loop that has left the CPU in the same state for the last few iterations,
+	* skips over its upcoming iterations until the end of the current run, or until PPUSTATUS could change
+	* (if the loop reads it). The elapsed cycle count and registers are left exactly as if they were executed.
+	* Nothing is skipped while a trace buffer is attached.
+	*/
+	void CheckIdleLoop(u16 startAddr, u16 branchAddr);
+
+	/**
+	* Clears the decoded block cache.
+	*/
+	void ClearDecodedBlocks();
+
+	/**
+	* Decodes a block of instructions starting at addr into block.
+	*/
+	void DecodeBlock(NESCPUDecodedBlock& block, u16 addr, u32 tag);
+
+	/**
+	* Gets the decoded block starting at addr, decoding it first if it isn't already cached.
+	* Returns nullptr if instructions cannot be cached at addr.
+	*/
+	const NESCPUDecodedBlock* GetDecodedBlock(u16 addr);
+
+	/**
+	* Gets the decoded instruction at PC, continuing through the current block if possible.
+	* Returns nullptr if the instruction could not be decoded from the cache.
+	*/
+	const NESCPUDecodedOp* FetchDecodedOp();
 
 	// Updates the Z bit of the P register. Sets to 1 if val is zero. Sets to 0 otherwise.
-	inline void UpdateRegZ(u8 val) { reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_Z_BIT, val == 0)); }
+	inline void UpdateRegZ(u8 val) { reg_.SetZResult(val); }
 
 	// Updates the N bit of the P register. Sets to the value of val's 7th bit (sign bit).
-	inline void UpdateRegN(u8 val) { reg_.SetP((reg_.GetP() & 0x7F) | (val & 0x80)); }
+	inline void UpdateRegN(u8 val) { reg_.SetNResult(val); }
+
+	// Updates the N and Z bits of the P register from the same value.
+	inline void UpdateRegNZ(u8 val) { reg_.SetNZResult(val); }
 
 	// Updates the PC register. Sets PC to val. currentOpChangedPC_ is set to true so PC is not automatically changed afterwards.
 	inline void UpdateRegPC(u16 val) { reg_.PC = val; currentOp_.opChangedPC = true; }
 
 	// Adds the specified amount of extra cycles to the current instruction's execution.
-	inline void OpAddCycles(int cycleAmount) { currentOp_.opCyclesLeft += cycleAmount; }
+	inline void OpAddCycles(int cycleAmount) { currentOp_.opEndCycle += cycleAmount; }
 
 	/**
-	* Reads the value of the next op's immediate argument depending on its addressing mode.
+	* Works out the address of the next op's argument from its operand depending on its addressing mode.
 	* Also checks if a page boundary was crossed.
-	* Returns the addr of the arg's value as the first member of the pair, and whether or not a page
-	* boundary was crossed as second.
+	* Returns the addr of the arg's value, and whether or not a page boundary was crossed.
 	*/
-	NESCPUOpArgInfo ReadOpArgInfo(NESCPUOpAddrMode addrMode);
+	template <NESCPUOpAddrMode addrMode>
+	inline NESCPUOpArgInfo ReadOpArgInfo(u16 operand)
+	{
+		NESCPUOpArgInfo argInfo(addrMode);
+
+		switch (addrMode)
+		{
+		case NESCPUOpAddrMode::ACCUMULATOR: // Instruction will need to read the register.
+		case NESCPUOpAddrMode::IMPLIED: // No operands for implied addr modes.
+		case NESCPUOpAddrMode::IMPLIED_BRK:
+			break;
+
+		case NESCPUOpAddrMode::IMMEDIATE:
+			argInfo.argAddr = reg_.PC + 1;
+			break;
+
+		case NESCPUOpAddrMode::RELATIVE:
+			// We add an extra 2 to the PC to cover the size of the rest of the instruction.
+			// The offset is a signed 2s complement number.
+			argInfo.argAddr = reg_.PC + 2 + static_cast<s8>(operand & 0xFF);
+			break;
+
+		case NESCPUOpAddrMode::INDIRECT:
+			argInfo.argAddr = ReadMemoryIndirect16(operand);
+			break;
+
+		case NESCPUOpAddrMode::INDIRECT_X:
+			argInfo.argAddr = ReadMemoryIndirect16((operand + reg_.X) & 0xFF);
+			break;
+
+		case NESCPUOpAddrMode::INDIRECT_Y:
+			argInfo.argAddr = ReadMemoryIndirect16(operand & 0xFF);
+			argInfo.crossedPage = !NESHelper::IsInSamePage(argInfo.argAddr, argInfo.argAddr + reg_.Y);
+			argInfo.argAddr += reg_.Y;
+			break;
+
+		case NESCPUOpAddrMode::ABSOLUTE:
+			argInfo.argAddr = operand;
+			break;
+
+		case NESCPUOpAddrMode::ABSOLUTE_X:
+			argInfo.argAddr = operand;
+			argInfo.crossedPage = !NESHelper::IsInSamePage(argInfo.argAddr, argInfo.argAddr + reg_.X);
+			argInfo.argAddr += reg_.X;
+			break;
+
+		case NESCPUOpAddrMode::ABSOLUTE_Y:
+			argInfo.argAddr = operand;
+			argInfo.crossedPage = !NESHelper::IsInSamePage(argInfo.argAddr, argInfo.argAddr + reg_.Y);
+			argInfo.argAddr += reg_.Y;
+			break;
+
+		case NESCPUOpAddrMode::ZEROPAGE:
+			argInfo.argAddr = operand & 0xFF;
+			break;
+
+		case NESCPUOpAddrMode::ZEROPAGE_X:
+			argInfo.argAddr = (operand + reg_.X) & 0xFF;
+			break;
+
+		case NESCPUOpAddrMode::ZEROPAGE_Y:
+			argInfo.argAddr = (operand + reg_.Y) & 0xFF;
+			break;
+
+		default:
+			// Unhandled addressing mode!
+			assert("Unknown addressing mode supplied to ReadOpArgInfo()!" && false);
+			break;
+		}
+
+		return argInfo;
+	}
 
 	/**
 	* Writes an op's result to the intended piece of memory / register.
+	* (This is inlined so that the switch on the addressing mode can be resolved at compile time).
 	*/
-	void WriteOpResult(NESCPUOpAddrMode addrMode, u8 result);
+	inline void WriteOpResult(const NESCPUOpArgInfo& argInfo, u8 result)
+	{
+		switch (argInfo.addrMode)
+		{
+		case NESCPUOpAddrMode::ACCUMULATOR:
+			reg_.A = result; // Write to accumulator instead.
+			return;
+
+		case NESCPUOpAddrMode::INDIRECT_X:
+		case NESCPUOpAddrMode::INDIRECT_Y:
+		case NESCPUOpAddrMode::ABSOLUTE:
+		case NESCPUOpAddrMode::ABSOLUTE_X:
+		case NESCPUOpAddrMode::ABSOLUTE_Y:
+		case NESCPUOpAddrMode::ZEROPAGE:
+		case NESCPUOpAddrMode::ZEROPAGE_X:
+		case NESCPUOpAddrMode::ZEROPAGE_Y:
+			// Assume writing to main memory at the arg's addr.
+			WriteMemory8(argInfo.argAddr, result);
+			return;
+
+		default:
+			// Unhandled addressing mode!
+			assert("Unknown addressing mode supplied to WriteOpResult()!" && false);
+			return;
+		}
+	}
 
 	/**
 	* Polls for the next interrupt to be executed while accounting for interrupt priority.
@@ -349,12 +772,17 @@ private:
 	*/
 	void ExecuteNextOp();
 
+	/**
+	* Records the instruction that is about to be executed to the trace buffer.
+	*/
+	void RecordTrace(u16 opSize, u16 operand);
+
 	// Push 8-bit value onto the stack.
 	inline void StackPush8(u8 val) 
 	{
 		// @NOTE: Some games purposely overflow the stack
 		// So there is no need to do any bounds checks.
-		comm_->Write8(NES_CPU_STACK_START + (reg_.SP--), val);
+		WriteMemory8(NES_CPU_STACK_START + (reg_.SP--), val);
 	}
 
 	// Push 16-bit value onto the stack.
@@ -370,7 +798,7 @@ private:
 	{
 		// @NOTE: Some games purposely underflow the stack
 		// So there is no need to do any bounds checks.
-		return comm_->Read8(NES_CPU_STACK_START + (++reg_.SP));
+		return ReadMemory8(NES_CPU_STACK_START + (++reg_.SP));
 	}
 
 	// Pull 16-bit value from the stack.
@@ -401,7 +829,12 @@ private:
 		OpAddCycles(NESHelper::IsInSamePage(reg_.PC, jumpAddr) ? 1 : 2);
 
 		// Jump to new PC.
+		const u16 branchAddr = reg_.PC;
 		UpdateRegPC(jumpAddr);
+
+		// Short backwards branches could be the end of an idle loop.
+		if (jumpAddr < branchAddr && branchAddr - jumpAddr <= NES_CPU_IDLE_LOOP_MAX_SIZE)
+			CheckIdleLoop(jumpAddr, branchAddr);
 	}
 
 	/**
@@ -412,19 +845,18 @@ private:
 	{
 		// Return A + M + C -> C
 		// @NOTE: NES 6502 variant has no BCD mode.
-		const u16 res = reg_.A + argVal + (NESHelper::IsBitSet(reg_.GetP(), NES_CPU_REG_P_C_BIT) ? 1 : 0);
+		const u16 res = reg_.A + argVal + (reg_.GetC() ? 1 : 0);
 
 		// If A and argVal have the same sign, then we have the potential to overflow (when considering 2s complement).
 		// If this is the case, and the sign has changed in the result (compare res with either A or argVal), 
-		// then we have overflowed. Set V.
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_V_BIT, ((~(reg_.A ^ argVal) & (reg_.A ^ res)) & 0x80) == 0x80));
+		// then we have overflowed. Set V (from bit 7 of the result).
+		reg_.SetVResult(~(reg_.A ^ argVal) & (reg_.A ^ res));
 
 		// Set carry if we can't represent this number using 8-bits (regardless of 2s complement).
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_C_BIT, res > 0xFF));
+		reg_.SetC(res > 0xFF);
 
 		const u8 res8 = res & 0xFF;
-		UpdateRegN(res8);
-		UpdateRegZ(res8);
+		UpdateRegNZ(res8);
 		return res8;
 	}
 
@@ -437,8 +869,7 @@ private:
 		// Return A AND M
 		const u8 res = reg_.A & argVal;
 
-		UpdateRegZ(res);
-		UpdateRegN(res);
+		UpdateRegNZ(res);
 		return res;
 	}
 
@@ -451,8 +882,7 @@ private:
 		// A OR M -> A
 		const u8 res = argVal | reg_.A;
 
-		UpdateRegZ(res);
-		UpdateRegN(res);
+		UpdateRegNZ(res);
 		return res;
 	}
 
@@ -465,8 +895,7 @@ private:
 		// A EOR M -> A
 		const u8 res = reg_.A ^ argVal;
 
-		UpdateRegN(res);
-		UpdateRegZ(res);
+		UpdateRegNZ(res);
 		return res;
 	}
 
@@ -478,14 +907,13 @@ private:
 	{
 		// C <- [7654321] <- C
 		// Shift to the left and append the carry bit in position 0 if set.
-		const u16 res = (argVal << 1) | (NESHelper::IsBitSet(reg_.GetP(), NES_CPU_REG_P_C_BIT) ? 1 : 0);
+		const u16 res = (argVal << 1) | (reg_.GetC() ? 1 : 0);
 
 		// Set the carry if there is a set bit in position 8 (which will be lost after we shift).
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_C_BIT, (res & 0x100) == 0x100));
+		reg_.SetC((res & 0x100) == 0x100);
 
 		const u8 res8 = res & 0xFF;
-		UpdateRegZ(res8);
-		UpdateRegN(res8);
+		UpdateRegNZ(res8);
 		return res8;
 	}
 
@@ -497,16 +925,15 @@ private:
 	{
 		// C -> [7654321] -> C
 		// Append the carry bit to position 8 if it is set.
-		const u16 unshiftedRes = argVal | (NESHelper::IsBitSet(reg_.GetP(), NES_CPU_REG_P_C_BIT) ? 0x100 : 0);
+		const u16 unshiftedRes = argVal | (reg_.GetC() ? 0x100 : 0);
 
 		// Set the carry bit if there is a set bit in position 0 (which will be lost after we shift).
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_C_BIT, (unshiftedRes & 1) == 1));
+		reg_.SetC((unshiftedRes & 1) == 1);
 
 		// Now we can shift to the right and safetly lose bit 0 (as it is recorded in the carry bit).
 		const u8 res = unshiftedRes >> 1;
 
-		UpdateRegZ(res);
-		UpdateRegN(res);
+		UpdateRegNZ(res);
 		return res;
 	}
 
@@ -521,9 +948,8 @@ private:
 		const u8 res = (argVal << 1) & 0xFF;
 
 		// Set carry bit if bit 7 (which was lost after the shift) was originally 1.
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_C_BIT, (argVal & 0x80) == 0x80));
-		UpdateRegZ(res);
-		UpdateRegN(res);
+		reg_.SetC((argVal & 0x80) == 0x80);
+		UpdateRegNZ(res);
 		return res;
 	}
 
@@ -538,9 +964,8 @@ private:
 		const u8 res = argVal >> 1;
 
 		// Set the carry if the original bit 0 (that we lost) was 1.
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_C_BIT, (argVal & 1) == 1));
-		UpdateRegZ(res);
-		UpdateRegN(res);
+		reg_.SetC((argVal & 1) == 1);
+		UpdateRegNZ(res);
 		return res;
 	}
 
@@ -551,11 +976,10 @@ private:
 	{
 		const u16 res = compareWith - argVal;
 
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_C_BIT, res < 0x100));
+		reg_.SetC(res < 0x100);
 
 		const u8 res8 = res & 0xFF;
-		UpdateRegN(res8);
-		UpdateRegZ(res8);
+		UpdateRegNZ(res8);
 	}
 
 	// Execute Add with Carry (ADC).
@@ -566,20 +990,20 @@ private:
 		if (argInfo.crossedPage)
 			OpAddCycles(1);
 
-		reg_.A = ExecuteAddWithCarry(comm_->Read8(argInfo.argAddr));
+		reg_.A = ExecuteAddWithCarry(ReadMemory8(argInfo.argAddr));
 	}
 
 	// Execute AND X with Accumulator, then AND with 7 (AHX).
 	inline void ExecuteOpAHX(NESCPUOpArgInfo& argInfo)
 	{
-		WriteOpResult(argInfo.addrMode, reg_.A & reg_.X & 7);
+		WriteOpResult(argInfo, reg_.A & reg_.X & 7);
 	}
 
 	// Execute AND with Accumulator, Set Carry if Negative (ANC).
 	inline void ExecuteOpANC(NESCPUOpArgInfo& argInfo)
 	{
-		reg_.A = ExecuteANDWithA(comm_->Read8(argInfo.argAddr));
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_C_BIT, (reg_.A & 0x80) == 0x80));
+		reg_.A = ExecuteANDWithA(ReadMemory8(argInfo.argAddr));
+		reg_.SetC((reg_.A & 0x80) == 0x80);
 	}
 
 	// Execute AND with Accumulator (AND).
@@ -590,22 +1014,21 @@ private:
 		if (argInfo.crossedPage)
 			OpAddCycles(1);
 
-		reg_.A = ExecuteANDWithA(comm_->Read8(argInfo.argAddr));
+		reg_.A = ExecuteANDWithA(ReadMemory8(argInfo.argAddr));
 	}
 
 	// Execute AND with Accumulator then Rotate Right in Accumulator (ARR).
 	inline void ExecuteOpARR(NESCPUOpArgInfo& argInfo)
 	{
 		// Append the carry bit to position 8 if it is set.
-		const u8 argVal = comm_->Read8(argInfo.argAddr);
-		const u8 res = (argVal | (NESHelper::IsBitSet(reg_.GetP(), NES_CPU_REG_P_C_BIT) ? 0x100 : 0)) >> 1;
+		const u8 argVal = ReadMemory8(argInfo.argAddr);
+		const u8 res = (argVal | (reg_.GetC() ? 0x100 : 0)) >> 1;
 
 		// C is set depending on bit 6 and V depends on bits 5 and 6.
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_C_BIT, (res & 0x40) == 0x40));
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_V_BIT, (((res & 0x40) >> 1) ^ (res & 0x20)) == 0x20));
+		reg_.SetC((res & 0x40) == 0x40);
+		reg_.SetV((((res & 0x40) >> 1) ^ (res & 0x20)) == 0x20);
 
-		UpdateRegZ(res);
-		UpdateRegN(res);
+		UpdateRegNZ(res);
 		reg_.A = res;
 	}
 
@@ -613,57 +1036,56 @@ private:
 	inline void ExecuteOpASL(NESCPUOpArgInfo& argInfo)
 	{
 		// C <- [76543210] <- 0
-		WriteOpResult(argInfo.addrMode,
-			ExecuteShiftLeft(argInfo.addrMode == NESCPUOpAddrMode::ACCUMULATOR ? reg_.A : comm_->Read8(argInfo.argAddr)));
+		WriteOpResult(argInfo,
+			ExecuteShiftLeft(argInfo.addrMode == NESCPUOpAddrMode::ACCUMULATOR ? reg_.A : ReadMemory8(argInfo.argAddr)));
 	}
 
 	// Execute AND with Accumulator then Shift Right (ASR).
 	inline void ExecuteOpASR(NESCPUOpArgInfo& argInfo)
 	{
-		reg_.A = ExecuteShiftRight(reg_.A & comm_->Read8(argInfo.argAddr));
+		reg_.A = ExecuteShiftRight(reg_.A & ReadMemory8(argInfo.argAddr));
 	}
 
 	// Execute AND X with A and Store in X then subtract byte from X (without borrow) (AXS).
 	inline void ExecuteOpAXS(NESCPUOpArgInfo& argInfo)
 	{
-		const u16 res = (reg_.X & reg_.A) - comm_->Read8(argInfo.argAddr);
+		const u16 res = (reg_.X & reg_.A) - ReadMemory8(argInfo.argAddr);
 
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_C_BIT, res < 0x100));
+		reg_.SetC(res < 0x100);
 
 		const u8 res8 = res & 0xFF;
-		UpdateRegN(res8);
-		UpdateRegZ(res8); // Check first 8-bits.
+		UpdateRegNZ(res8); // Check first 8-bits.
 		reg_.X = res8;
 	}
 
 	// Execute Branch on Carry Clear (BCC).
-	inline void ExecuteOpBCC(NESCPUOpArgInfo& argInfo) { /* Branch on C = 0 */ ExecuteBranch(argInfo.argAddr, !NESHelper::IsBitSet(reg_.GetP(), NES_CPU_REG_P_C_BIT)); }
+	inline void ExecuteOpBCC(NESCPUOpArgInfo& argInfo) { /* Branch on C = 0 */ ExecuteBranch(argInfo.argAddr, !reg_.GetC()); }
 
 	// Execute Branch on Carry Set (BCS).
-	inline void ExecuteOpBCS(NESCPUOpArgInfo& argInfo) { /* Branch on C = 1 */ ExecuteBranch(argInfo.argAddr, NESHelper::IsBitSet(reg_.GetP(), NES_CPU_REG_P_C_BIT)); }
+	inline void ExecuteOpBCS(NESCPUOpArgInfo& argInfo) { /* Branch on C = 1 */ ExecuteBranch(argInfo.argAddr, reg_.GetC()); }
 
 	// Execute Branch on Result Zero (BEQ).
-	inline void ExecuteOpBEQ(NESCPUOpArgInfo& argInfo) { /* Branch on Z = 1 */ ExecuteBranch(argInfo.argAddr, NESHelper::IsBitSet(reg_.GetP(), NES_CPU_REG_P_Z_BIT)); }
+	inline void ExecuteOpBEQ(NESCPUOpArgInfo& argInfo) { /* Branch on Z = 1 */ ExecuteBranch(argInfo.argAddr, reg_.GetZ()); }
 
 	// Execute Test Bits in Memory with Accumulator (BIT).
 	inline void ExecuteOpBIT(NESCPUOpArgInfo& argInfo)
 	{
 		// A /\ M, M7 -> N, M6 -> V
-		const u8 argVal = comm_->Read8(argInfo.argAddr);
+		const u8 argVal = ReadMemory8(argInfo.argAddr);
 
 		UpdateRegN(argVal);
 		UpdateRegZ(argVal & reg_.A);
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_V_BIT, (argVal & 0x40) == 0x40));
+		reg_.SetVResult(static_cast<u8>(argVal << 1));
 	}
 
 	// Execute Branch on Result Minus (BMI).
-	inline void ExecuteOpBMI(NESCPUOpArgInfo& argInfo) { /* Branch on N = 1 */ ExecuteBranch(argInfo.argAddr, NESHelper::IsBitSet(reg_.GetP(), NES_CPU_REG_P_N_BIT)); }
+	inline void ExecuteOpBMI(NESCPUOpArgInfo& argInfo) { /* Branch on N = 1 */ ExecuteBranch(argInfo.argAddr, reg_.GetN()); }
 
 	// Execute Branch on Result Not Zero (BNE).
-	inline void ExecuteOpBNE(NESCPUOpArgInfo& argInfo) { /* Branch on Z = 0 */ ExecuteBranch(argInfo.argAddr, !NESHelper::IsBitSet(reg_.GetP(), NES_CPU_REG_P_Z_BIT)); }
+	inline void ExecuteOpBNE(NESCPUOpArgInfo& argInfo) { /* Branch on Z = 0 */ ExecuteBranch(argInfo.argAddr, !reg_.GetZ()); }
 
 	// Execute Branch on Result Plus (BPL).
-	inline void ExecuteOpBPL(NESCPUOpArgInfo& argInfo) { /* Branch on N = 0 */ ExecuteBranch(argInfo.argAddr, !NESHelper::IsBitSet(reg_.GetP(), NES_CPU_REG_P_N_BIT)); }
+	inline void ExecuteOpBPL(NESCPUOpArgInfo& argInfo) { /* Branch on N = 0 */ ExecuteBranch(argInfo.argAddr, !reg_.GetN()); }
 
 	// Execute Force Break (BRK).
 	inline void ExecuteOpBRK(NESCPUOpArgInfo& argInfo)
@@ -671,28 +1093,28 @@ private:
 		// Forced Interrupt PC + 2 toS P toS 
 		StackPush16(reg_.PC + 2); // There is a padding byte after the opcode, hence the +2.
 		StackPush8(reg_.GetP() | 0x10); // Make sure bit 5 is set on the copy we push.
-		reg_.SetP(NESHelper::SetBit(reg_.GetP(), NES_CPU_REG_P_I_BIT));
+		reg_.SetI(true);
 		
-		UpdateRegPC(NESHelper::MemoryRead16(*comm_, 0xFFFE));
+		UpdateRegPC(ReadMemory16(0xFFFE));
 	}
 
 	// Execute Branch on Overflow Clear (BVC).
-	inline void ExecuteOpBVC(NESCPUOpArgInfo& argInfo) { /* Branch on V = 0 */ ExecuteBranch(argInfo.argAddr, !NESHelper::IsBitSet(reg_.GetP(), NES_CPU_REG_P_V_BIT)); }
+	inline void ExecuteOpBVC(NESCPUOpArgInfo& argInfo) { /* Branch on V = 0 */ ExecuteBranch(argInfo.argAddr, !reg_.GetV()); }
 
 	// Execute Branch on Overflow Set (BVS).
-	inline void ExecuteOpBVS(NESCPUOpArgInfo& argInfo) { /* Branch on V = 1 */ ExecuteBranch(argInfo.argAddr, NESHelper::IsBitSet(reg_.GetP(), NES_CPU_REG_P_V_BIT)); }
+	inline void ExecuteOpBVS(NESCPUOpArgInfo& argInfo) { /* Branch on V = 1 */ ExecuteBranch(argInfo.argAddr, reg_.GetV()); }
 
 	// Execute Clear Carry Flag (CLC).
-	inline void ExecuteOpCLC(NESCPUOpArgInfo& argInfo) { /* 0 -> C */ reg_.SetP(NESHelper::ClearBit(reg_.GetP(), NES_CPU_REG_P_C_BIT)); }
+	inline void ExecuteOpCLC(NESCPUOpArgInfo& argInfo) { /* 0 -> C */ reg_.SetC(false); }
 
 	// Execute Clear Decimal Mode (CLD).
-	inline void ExecuteOpCLD(NESCPUOpArgInfo& argInfo) { /* 0 -> D */ reg_.SetP(NESHelper::ClearBit(reg_.GetP(), NES_CPU_REG_P_D_BIT)); }
+	inline void ExecuteOpCLD(NESCPUOpArgInfo& argInfo) { /* 0 -> D */ reg_.SetD(false); }
 
 	// Execute Clear Interrupt Disable Bit (CLI).
-	inline void ExecuteOpCLI(NESCPUOpArgInfo& argInfo) { /* 0 -> I */ reg_.SetP(NESHelper::ClearBit(reg_.GetP(), NES_CPU_REG_P_I_BIT)); }
+	inline void ExecuteOpCLI(NESCPUOpArgInfo& argInfo) { /* 0 -> I */ reg_.SetI(false); }
 
 	// Execute Clear Overflow Flag (CLV).
-	inline void ExecuteOpCLV(NESCPUOpArgInfo& argInfo) { /* 0 -> V */ reg_.SetP(NESHelper::ClearBit(reg_.GetP(), NES_CPU_REG_P_V_BIT)); }
+	inline void ExecuteOpCLV(NESCPUOpArgInfo& argInfo) { /* 0 -> V */ reg_.SetV(false); }
 
 	// Execute Compare Memory and Accumulator (CMP).
 	inline void ExecuteOpCMP(NESCPUOpArgInfo& argInfo)
@@ -702,41 +1124,40 @@ private:
 			OpAddCycles(1);
 
 		// A - M
-		ExecuteComparison(comm_->Read8(argInfo.argAddr), reg_.A);
+		ExecuteComparison(ReadMemory8(argInfo.argAddr), reg_.A);
 	}
 
 	// Execute Compare Memory and Index X (CPX).
 	inline void ExecuteOpCPX(NESCPUOpArgInfo& argInfo)
 	{
 		// X - M
-		ExecuteComparison(comm_->Read8(argInfo.argAddr), reg_.X);
+		ExecuteComparison(ReadMemory8(argInfo.argAddr), reg_.X);
 	}
 
 	// Execute Compare Memory and Index Y (CPY).
 	inline void ExecuteOpCPY(NESCPUOpArgInfo& argInfo)
 	{
 		// Y - M
-		ExecuteComparison(comm_->Read8(argInfo.argAddr), reg_.Y);
+		ExecuteComparison(ReadMemory8(argInfo.argAddr), reg_.Y);
 	}
 
 	// Execute Subtract 1 from Memory (Without Borrow) (DCP).
 	inline void ExecuteOpDCP(NESCPUOpArgInfo& argInfo)
 	{
-		const u8 res = comm_->Read8(argInfo.argAddr) - 1;
-		WriteOpResult(argInfo.addrMode, res);
+		const u8 res = ReadMemory8(argInfo.argAddr) - 1;
+		WriteOpResult(argInfo, res);
 
-		ExecuteComparison(comm_->Read8(argInfo.argAddr), reg_.A);
+		ExecuteComparison(ReadMemory8(argInfo.argAddr), reg_.A);
 	}
 
 	// Execute Decrement Memory by One (DEC).
 	inline void ExecuteOpDEC(NESCPUOpArgInfo& argInfo)
 	{
 		// M - 1 -> M
-		const u8 res = comm_->Read8(argInfo.argAddr) - 1;
-		WriteOpResult(argInfo.addrMode, res);
+		const u8 res = ReadMemory8(argInfo.argAddr) - 1;
+		WriteOpResult(argInfo, res);
 
-		UpdateRegN(res);
-		UpdateRegZ(res);
+		UpdateRegNZ(res);
 	}
 
 	// Execute Decrement Index X by One (DEX).
@@ -744,8 +1165,7 @@ private:
 	{
 		// X - 1 -> X
 		--reg_.X;
-		UpdateRegN(reg_.X);
-		UpdateRegZ(reg_.X);
+		UpdateRegNZ(reg_.X);
 	}
 
 	// Execute Decrement Index Y by One (DEY).
@@ -753,8 +1173,7 @@ private:
 	{
 		// Y - 1 -> Y
 		--reg_.Y;
-		UpdateRegN(reg_.Y);
-		UpdateRegZ(reg_.Y);
+		UpdateRegNZ(reg_.Y);
 	}
 
 	// Execute "Exclusive-Or" Memory with Accumulator (EOR).
@@ -765,18 +1184,17 @@ private:
 		if (argInfo.crossedPage)
 			OpAddCycles(1);
 
-		reg_.A = ExecuteEORWithA(comm_->Read8(argInfo.argAddr));
+		reg_.A = ExecuteEORWithA(ReadMemory8(argInfo.argAddr));
 	}
 
 	// Execute Increment Memory by One (INC).
 	inline void ExecuteOpINC(NESCPUOpArgInfo& argInfo)
 	{
 		// M + 1 -> M
-		const u8 res = comm_->Read8(argInfo.argAddr) + 1;
-		WriteOpResult(argInfo.addrMode, res);
+		const u8 res = ReadMemory8(argInfo.argAddr) + 1;
+		WriteOpResult(argInfo, res);
 
-		UpdateRegN(res);
-		UpdateRegZ(res);
+		UpdateRegNZ(res);
 	}
 
 	// Execute Increment Index X by One (INX).
@@ -784,8 +1202,7 @@ private:
 	{
 		// X + 1 -> X
 		++reg_.X;
-		UpdateRegN(reg_.X);
-		UpdateRegZ(reg_.X);
+		UpdateRegNZ(reg_.X);
 	}
 
 	// Execute Increment Index Y by One (INY).
@@ -793,15 +1210,14 @@ private:
 	{
 		// Y + 1 -> Y
 		++reg_.Y;
-		UpdateRegN(reg_.Y);
-		UpdateRegZ(reg_.Y);
+		UpdateRegNZ(reg_.Y);
 	}
 
 	// Execute Increase Memory by 1, then Subtract Memory from Accumulator (ISC).
 	inline void ExecuteOpISC(NESCPUOpArgInfo& argInfo)
 	{
-		const u8 res = comm_->Read8(argInfo.argAddr) + 1;
-		WriteOpResult(argInfo.addrMode, res);
+		const u8 res = ReadMemory8(argInfo.argAddr) + 1;
+		WriteOpResult(argInfo, res);
 
 		reg_.A = ExecuteAddWithCarry(~res);
 	}
@@ -837,11 +1253,10 @@ private:
 		if (argInfo.crossedPage)
 			OpAddCycles(1);
 
-		const u8 res = comm_->Read8(argInfo.argAddr) & reg_.SP;
+		const u8 res = ReadMemory8(argInfo.argAddr) & reg_.SP;
 
 		reg_.A = reg_.X = reg_.SP = res;
-		UpdateRegN(res);
-		UpdateRegZ(res);
+		UpdateRegNZ(res);
 	}
 
 	// Execute Load Accumulator and X with Memory (LAX).
@@ -851,11 +1266,10 @@ private:
 		if (argInfo.crossedPage)
 			OpAddCycles(1);
 
-		const u8 res = comm_->Read8(argInfo.argAddr);
+		const u8 res = ReadMemory8(argInfo.argAddr);
 
 		reg_.A = reg_.X = res;
-		UpdateRegN(res);
-		UpdateRegZ(res);
+		UpdateRegNZ(res);
 	}
 
 	// Execute Load Accumulator with Memory (LDA).
@@ -866,10 +1280,9 @@ private:
 			OpAddCycles(1);
 
 		// M -> A
-		const u8 argVal = comm_->Read8(argInfo.argAddr);
+		const u8 argVal = ReadMemory8(argInfo.argAddr);
 
-		UpdateRegN(argVal);
-		UpdateRegZ(argVal);
+		UpdateRegNZ(argVal);
 		reg_.A = argVal;
 	}
 
@@ -881,10 +1294,9 @@ private:
 			OpAddCycles(1);
 
 		// M -> X
-		const u8 argVal = comm_->Read8(argInfo.argAddr);
+		const u8 argVal = ReadMemory8(argInfo.argAddr);
 
-		UpdateRegN(argVal);
-		UpdateRegZ(argVal);
+		UpdateRegNZ(argVal);
 		reg_.X = argVal;
 	}
 
@@ -896,10 +1308,9 @@ private:
 			OpAddCycles(1);
 
 		// M -> Y
-		const u8 argVal = comm_->Read8(argInfo.argAddr);
+		const u8 argVal = ReadMemory8(argInfo.argAddr);
 
-		UpdateRegN(argVal);
-		UpdateRegZ(argVal);
+		UpdateRegNZ(argVal);
 		reg_.Y = argVal;
 	}
 
@@ -907,8 +1318,8 @@ private:
 	inline void ExecuteOpLSR(NESCPUOpArgInfo& argInfo)
 	{
 		// 0 -> [76543210] -> C
-		WriteOpResult(argInfo.addrMode, 
-			ExecuteShiftRight(argInfo.addrMode == NESCPUOpAddrMode::ACCUMULATOR ? reg_.A : comm_->Read8(argInfo.argAddr)));
+		WriteOpResult(argInfo, 
+			ExecuteShiftRight(argInfo.addrMode == NESCPUOpAddrMode::ACCUMULATOR ? reg_.A : ReadMemory8(argInfo.argAddr)));
 	}
 
 	// Execute No Operation (Do Nothing) (NOP).
@@ -930,7 +1341,7 @@ private:
 		if (argInfo.crossedPage)
 			OpAddCycles(1);
 
-		reg_.A = ExecuteORWithA(comm_->Read8(argInfo.argAddr));
+		reg_.A = ExecuteORWithA(ReadMemory8(argInfo.argAddr));
 	}
 
 	// Execute Push Accumulator to Stack (PHA).
@@ -950,8 +1361,7 @@ private:
 		// A fromS.
 		const u8 val = StackPull8();
 
-		UpdateRegZ(val);
-		UpdateRegN(val);
+		UpdateRegNZ(val);
 		reg_.A = val;
 	}
 
@@ -967,11 +1377,11 @@ private:
 	inline void ExecuteOpRLA(NESCPUOpArgInfo& argInfo)
 	{
 		// Shift to the left and append the carry bit in position 0 if set.
-		const u16 rotateRes = (comm_->Read8(argInfo.argAddr) << 1) | (NESHelper::IsBitSet(reg_.GetP(), NES_CPU_REG_P_C_BIT) ? 1 : 0);
+		const u16 rotateRes = (ReadMemory8(argInfo.argAddr) << 1) | (reg_.GetC() ? 1 : 0);
 
 		// Set the carry if there is a set bit in position 8 (which will be lost after we shift).
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_C_BIT, (rotateRes & 0x100) == 0x100));
-		WriteOpResult(argInfo.addrMode, rotateRes & 0xFF);
+		reg_.SetC((rotateRes & 0x100) == 0x100);
+		WriteOpResult(argInfo, rotateRes & 0xFF);
 
 		reg_.A = ExecuteANDWithA(rotateRes & 0xFF);
 	}
@@ -980,14 +1390,14 @@ private:
 	inline void ExecuteOpRRA(NESCPUOpArgInfo& argInfo)
 	{
 		// Append the carry bit to position 8 if it is set.
-		const u16 unshiftedRes = comm_->Read8(argInfo.argAddr) | (NESHelper::IsBitSet(reg_.GetP(), NES_CPU_REG_P_C_BIT) ? 0x100 : 0);
+		const u16 unshiftedRes = ReadMemory8(argInfo.argAddr) | (reg_.GetC() ? 0x100 : 0);
 
 		// Set the carry bit if there is a set bit in position 0 (which will be lost after we shift).
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_C_BIT, (unshiftedRes & 1) == 1));
+		reg_.SetC((unshiftedRes & 1) == 1);
 
 		// Now we can shift to the right and safetly lose bit 0 (as it is recorded in the carry bit).
 		const u8 rotateRes = unshiftedRes >> 1;
-		WriteOpResult(argInfo.addrMode, rotateRes);
+		WriteOpResult(argInfo, rotateRes);
 
 		reg_.A = ExecuteAddWithCarry(rotateRes);
 	}
@@ -996,16 +1406,16 @@ private:
 	inline void ExecuteOpROL(NESCPUOpArgInfo& argInfo)
 	{
 		// C <-[7654321] <- C
-		WriteOpResult(argInfo.addrMode, 
-			ExecuteRotateLeft(argInfo.addrMode == NESCPUOpAddrMode::ACCUMULATOR ? reg_.A : comm_->Read8(argInfo.argAddr)));
+		WriteOpResult(argInfo, 
+			ExecuteRotateLeft(argInfo.addrMode == NESCPUOpAddrMode::ACCUMULATOR ? reg_.A : ReadMemory8(argInfo.argAddr)));
 	}
 
 	// Execute Rotate One Bit Right (ROR).
 	inline void ExecuteOpROR(NESCPUOpArgInfo& argInfo)
 	{
 		// C -> [7654321] -> C
-		WriteOpResult(argInfo.addrMode,
-			ExecuteRotateRight(argInfo.addrMode == NESCPUOpAddrMode::ACCUMULATOR ? reg_.A : comm_->Read8(argInfo.argAddr)));
+		WriteOpResult(argInfo,
+			ExecuteRotateRight(argInfo.addrMode == NESCPUOpAddrMode::ACCUMULATOR ? reg_.A : ReadMemory8(argInfo.argAddr)));
 	}
 
 	// Execute Return from Interrupt (RTI).
@@ -1023,7 +1433,7 @@ private:
 	// Execute AND X Register with Accumulator and Store Result in Memory (SAX).
 	inline void ExecuteOpSAX(NESCPUOpArgInfo& argInfo)
 	{
-		WriteOpResult(argInfo.addrMode, reg_.A & reg_.X);
+		WriteOpResult(argInfo, reg_.A & reg_.X);
 	}
 
 	// Execute Subtract Memory from Accumulator with Borrow (SBC).
@@ -1037,43 +1447,43 @@ private:
 		// Simply just execute ADC with the bitwise complement of argVal.
 		// In 2s complement, this will = (-argVal) - 1.
 		// If the carry flag is set, 1 will be added to make it -argVal as intended.
-		reg_.A = ExecuteAddWithCarry(~comm_->Read8(argInfo.argAddr));
+		reg_.A = ExecuteAddWithCarry(~ReadMemory8(argInfo.argAddr));
 	}
 
 	// Execute Set Carry Flag (SEC).
-	inline void ExecuteOpSEC(NESCPUOpArgInfo& argInfo) { /* 1 -> C */ reg_.SetP(NESHelper::SetBit(reg_.GetP(), NES_CPU_REG_P_C_BIT)); }
+	inline void ExecuteOpSEC(NESCPUOpArgInfo& argInfo) { /* 1 -> C */ reg_.SetC(true); }
 
 	// Execute Set Decimal Mode (SED).
-	inline void ExecuteOpSED(NESCPUOpArgInfo& argInfo) { /* 1 -> D */ reg_.SetP(NESHelper::SetBit(reg_.GetP(), NES_CPU_REG_P_D_BIT)); }
+	inline void ExecuteOpSED(NESCPUOpArgInfo& argInfo) { /* 1 -> D */ reg_.SetD(true); }
 
 	// Execute Set Interrupt Disable Status (SEI).
-	inline void ExecuteOpSEI(NESCPUOpArgInfo& argInfo) { /* 1 -> I */ reg_.SetP(NESHelper::SetBit(reg_.GetP(), NES_CPU_REG_P_I_BIT)); }
+	inline void ExecuteOpSEI(NESCPUOpArgInfo& argInfo) { /* 1 -> I */ reg_.SetI(true); }
 
 	// Execute SHX.
 	inline void ExecuteOpSHX(NESCPUOpArgInfo& argInfo)
 	{
 		const u8 res = reg_.X & (argInfo.argAddr >> 8);
-		comm_->Write8(NESHelper::ConvertTo16(res, argInfo.argAddr & 0xFF), res);
+		WriteMemory8(NESHelper::ConvertTo16(res, argInfo.argAddr & 0xFF), res);
 	}
 
 	// Execute SHY.
 	inline void ExecuteOpSHY(NESCPUOpArgInfo& argInfo)
 	{
 		const u8 res = reg_.Y & (argInfo.argAddr >> 8);
-		comm_->Write8(NESHelper::ConvertTo16(res, argInfo.argAddr & 0xFF), res);
+		WriteMemory8(NESHelper::ConvertTo16(res, argInfo.argAddr & 0xFF), res);
 	}
 
 	// Execute Shift Right, then EOR Accumulator (SRE).
 	inline void ExecuteOpSRE(NESCPUOpArgInfo& argInfo)
 	{
 		// Shift to the right. We will lose bit 0 in the process, and bit 7 should become 0.
-		const u8 argVal = comm_->Read8(argInfo.argAddr);
+		const u8 argVal = ReadMemory8(argInfo.argAddr);
 		const u8 shiftRes = argVal >> 1;
 
 		// Set the carry if the original bit 0 (that we lost) was 1.
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_C_BIT, (argVal & 1) == 1));
+		reg_.SetC((argVal & 1) == 1);
 
-		WriteOpResult(argInfo.addrMode, shiftRes);
+		WriteOpResult(argInfo, shiftRes);
 		reg_.A = ExecuteEORWithA(shiftRes);
 	}
 
@@ -1081,24 +1491,24 @@ private:
 	inline void ExecuteOpSLO(NESCPUOpArgInfo& argInfo)
 	{
 		// Shift to the left. Bit now in position 0 should be 0. Bit originally in pos 8 is lost.
-		const u8 argVal = comm_->Read8(argInfo.argAddr);
+		const u8 argVal = ReadMemory8(argInfo.argAddr);
 		const u8 shiftRes = (argVal << 1) & 0xFF;
 
 		// Set carry bit if bit 7 (which was lost after the shift) was originally 1.
-		reg_.SetP(NESHelper::EditBit(reg_.GetP(), NES_CPU_REG_P_C_BIT, (argVal & 0x80) == 0x80));
+		reg_.SetC((argVal & 0x80) == 0x80);
 
-		WriteOpResult(argInfo.addrMode, shiftRes);
+		WriteOpResult(argInfo, shiftRes);
 		reg_.A = ExecuteORWithA(shiftRes);
 	}
 
 	// Execute Store Accumulator in Memory (STA).
-	inline void ExecuteOpSTA(NESCPUOpArgInfo& argInfo) { /* A -> M */ comm_->Write8(argInfo.argAddr, reg_.A); }
+	inline void ExecuteOpSTA(NESCPUOpArgInfo& argInfo) { /* A -> M */ WriteMemory8(argInfo.argAddr, reg_.A); }
 
 	// Execute Store Index X in Memory (STX).
-	inline void ExecuteOpSTX(NESCPUOpArgInfo& argInfo) { /* X -> M */ comm_->Write8(argInfo.argAddr, reg_.X); }
+	inline void ExecuteOpSTX(NESCPUOpArgInfo& argInfo) { /* X -> M */ WriteMemory8(argInfo.argAddr, reg_.X); }
 
 	// Execute Store Index Y in Memory (STY).
-	inline void ExecuteOpSTY(NESCPUOpArgInfo& argInfo) { /* Y -> M */ comm_->Write8(argInfo.argAddr, reg_.Y); }
+	inline void ExecuteOpSTY(NESCPUOpArgInfo& argInfo) { /* Y -> M */ WriteMemory8(argInfo.argAddr, reg_.Y); }
 
 	// Execute AND X with Accumulator, Store in SP, then AND SP with High Byte of Arg Addr + 1 (TAS).
 	inline void ExecuteOpTAS(NESCPUOpArgInfo& argInfo)
@@ -1111,8 +1521,7 @@ private:
 	{ 
 		// A -> Y 
 		reg_.Y = reg_.A;
-		UpdateRegN(reg_.Y);
-		UpdateRegZ(reg_.Y);
+		UpdateRegNZ(reg_.Y);
 	}
 
 	// Execute Transfer Accumulator to Index X (TAX).
@@ -1120,8 +1529,7 @@ private:
 	{ 
 		// A -> X 
 		reg_.X = reg_.A;
-		UpdateRegN(reg_.X);
-		UpdateRegZ(reg_.X);
+		UpdateRegNZ(reg_.X);
 	}
 
 	// Execute Transfer Stack Pointer to Index X (TSX).
@@ -1129,8 +1537,7 @@ private:
 	{ 
 		// S -> X 
 		reg_.X = reg_.SP;
-		UpdateRegN(reg_.X);
-		UpdateRegZ(reg_.X);
+		UpdateRegNZ(reg_.X);
 	}
 
 	// Execute Transfer Index X to Accumulator (TXA).
@@ -1138,8 +1545,7 @@ private:
 	{ 
 		// X -> A
 		reg_.A = reg_.X; 
-		UpdateRegN(reg_.A);
-		UpdateRegZ(reg_.A);
+		UpdateRegNZ(reg_.A);
 	}
 
 	// Execute Transfer Index X to Stack Pointer (TXS).
@@ -1150,8 +1556,7 @@ private:
 	{ 
 		// Y -> A 
 		reg_.A = reg_.Y; 
-		UpdateRegN(reg_.A);
-		UpdateRegZ(reg_.A);
+		UpdateRegNZ(reg_.A);
 	}
 
 	// Execute XAA.
@@ -1159,6 +1564,6 @@ private:
 	{
 		// This instruction is weird. More info at:
 		// http://visual6502.org/wiki/index.php?title=6502_Opcode_8B_%28XAA,_ANE%29
-		reg_.A = reg_.X & comm_->Read8(argInfo.argAddr) & (reg_.A | 0xEE);
+		reg_.A = reg_.X & ReadMemory8(argInfo.argAddr) & (reg_.A | 0xEE);
 	}
 };
\ No newline at end of file
@@ -3,13 +3,18 @@
 #include "NESController.h"
 
 
-NESCPUEmuComm::NESCPUEmuComm(NESMemCPURAM& ram, NESPPU& ppu, INESMMC& mmc, 
+NESCPUEmuComm::NESCPUEmuComm(NESMemCPURAM& ram, NESCPU& cpu, NESPPU& ppu, INESMMC& mmc, 
 	const NESControllerPorts& controllers) :
 ram_(ram),
+cpu_(cpu),
 ppu_(ppu),
 mmc_(mmc),
-controllers_(controllers)
+controllers_(controllers),
+testMonitor_(nullptr)
 {
+	// RAM is mirrored every $800 bytes up until $2000.
+	pageTable_.MapReadWrite(0x0000, 0x2000, ram_.GetData(), ram_.GetSize());
+	mmc_.AttachCPUPageTable(&pageTable_);
 }
 
 
@@ -18,6 +23,17 @@ NESCPUEmuComm::~NESCPUEmuComm()
 }
 
 
+void NESCPUEmuComm::SetTestStatusMonitor(NESTestStatusMonitor* testMonitor)
+{
+	// Writes to the test status page need to go through WriteIO() so that the monitor sees them.
+	// @NOTE: The page stays watched if the monitor is removed, which is harmless.
+	if (testMonitor != nullptr)
+		pageTable_.WatchWrites(NES_TEST_STATUS_PAGE_START, 0x100);
+
+	testMonitor_ = testMonitor;
+}
+
+
 NESPPURegisterType NESCPUEmuComm::GetPPURegister(u16 realAddr)
 {
 	switch (realAddr)
@@ -56,13 +72,41 @@ NESPPURegisterType NESCPUEmuComm::GetPPURegister(u16 realAddr)
 
 
 void NESCPUEmuComm::Write8(u16 addr, u8 val)
+{
+	const auto page = pageTable_.GetWritePage(addr);
+
+	if (page != nullptr)
+		page[addr & 0xFF] = val;
+	else
+		WriteIO(addr, val);
+}
+
+
+u8 NESCPUEmuComm::Read8(u16 addr) const
+{
+	const auto page = pageTable_.GetReadPage(addr);
+	return (page != nullptr ? page[addr & 0xFF] : ReadIO(addr));
+}
+
+
+void NESCPUEmuComm::WriteIO(u16 addr, u8 val)
 {
 	if (addr < 0x2000) // RAM
 		ram_.Write8(addr & 0x7FF, val);
 	else if (addr < 0x4000) // PPU I/O Registers
+	{
+		SyncPPU();
 		ppu_.WriteRegister(GetPPURegister(0x2000 + (addr & 7)), val);
+
+		// The write may have changed when the PPU next needs to be synced with.
+		cpu_.EndRun();
+	}
 	else if (addr == 0x4014) // PPU I/O OAMDATA Register
+	{
+		SyncPPU();
 		ppu_.WriteRegister(GetPPURegister(0x4014), val);
+		cpu_.EndRun();
+	}
 	else if (addr < 0x4016) // pAPU I/O Registers
 		return; // @TODO
 	else if (addr == 0x4016) // Controller Strobe
@@ -77,18 +121,38 @@ void NESCPUEmuComm::Write8(u16 addr, u8 val)
 	else if (addr == 0x4017) // pAPU Frame Counter
 		return; // @TODO
 	else // Use the MMC
+	{
+		// Mapper register writes can change the CHR banks and mirroring used by the PPU.
+		if (addr >= 0x8000)
+			SyncPPU();
+
 		mmc_.Write8(addr, val);
+
+		// Switching CHR banks can change when sprite-0 hits happen.
+		if (addr >= 0x8000)
+			ppu_.InvalidateEventPrediction();
+
+		if (testMonitor_ != nullptr && addr >= NES_TEST_STATUS_PAGE_START && addr <= NES_TEST_STATUS_PAGE_END &&
+			testMonitor_->OnWrite(*this, addr))
+			cpu_.SetInterrupt(NESCPUInterruptType::RESET);
+	}
 }
 
 
-u8 NESCPUEmuComm::Read8(u16 addr) const
+u8 NESCPUEmuComm::ReadIO(u16 addr) const
 {
 	if (addr < 0x2000) // RAM
 		return ram_.Read8(addr & 0x7FF);
 	else if (addr < 0x4000) // PPU I/O Registers
+	{
+		SyncPPU();
 		return ppu_.ReadRegister(GetPPURegister(0x2000 + (addr & 7)));
+	}
 	else if (addr == 0x4014) // PPU I/O OAMDATA Register
+	{
+		SyncPPU();
 		return ppu_.ReadRegister(GetPPURegister(0x4014));
+	}
 	else if (addr < 0x4016) // pAPU I/O Registers
 		return 0; // @TODO
 	else if (addr < 0x4018) // Controllers 1 and 2
@@ -3,6 +3,7 @@
 #include "NESCPU.h"
 #include "NESPPU.h"
 #include "NESMMC.h"
+#include "NESTestStatusMonitor.h"
 
 class INESController;
 
@@ -15,18 +16,62 @@ typedef std::array<INESController*, 2> NESControllerPorts;
 class NESCPUEmuComm : public INESCPUCommunicationsInterface
 {
 public:
-	NESCPUEmuComm(NESMemCPURAM& ram, NESPPU& ppu, INESMMC& mmc, const NESControllerPorts& controllers);
+	NESCPUEmuComm(NESMemCPURAM& ram, NESCPU& cpu, NESPPU& ppu, INESMMC& mmc, const NESControllerPorts& controllers);
 	virtual ~NESCPUEmuComm();
 
 	void Write8(u16 addr, u8 val) override;
 	u8 Read8(u16 addr) const override;
 
+	inline std::size_t GetPRGBankIndex(u16 addr) const override { return mmc_.GetPRGBankIndex(addr); }
+	inline const NESMemoryPageTable& GetPageTable() const override { return pageTable_; }
+
+	inline u64 GetPPUStatusStableUntilCycle() override
+	{
+		SyncPPU();
+		return ppu_.GetNextStatusChangeCycle() / NES_PPU_CYCLES_PER_CPU_CYCLE;
+	}
+
+	inline void GetPPUPosition(u16& scanline, u16& cycle) const override
+	{
+		// Work the position out instead of syncing the PPU, so that tracing doesn't change how the PPU is caught up.
+		unsigned int ppuScanline, ppuCycle;
+		ppu_.GetPositionAtCycle(cpu_.GetElapsedCycles() * NES_PPU_CYCLES_PER_CPU_CYCLE, ppuScanline, ppuCycle);
+
+		scanline = static_cast<u16>(ppuScanline);
+		cycle = static_cast<u16>(ppuCycle);
+	}
+
+	/**
+	* Sets the monitor that watches writes to the test status page. Pass nullptr to stop monitoring.
+	*/
+	void SetTestStatusMonitor(NESTestStatusMonitor* testMonitor);
+
 private:
 	static NESPPURegisterType GetPPURegister(u16 realAddr);
 
+	// Maps RAM and the MMC's SRAM and PRG-ROM. Everything else is handled by WriteIO() and ReadIO().
+	NESMemoryPageTable pageTable_;
+
 	NESMemCPURAM& ram_;
+	NESCPU& cpu_;
 	NESPPU& ppu_;
 	INESMMC& mmc_;
 	const NESControllerPorts& controllers_;
+	NESTestStatusMonitor* testMonitor_;
+
+	/**
+	* Handles writes to addresses that aren't mapped in the page table.
+	*/
+	void WriteIO(u16 addr, u8 val);
+
+	/**
+	* Handles reads from addresses that aren't mapped in the page table.
+	*/
+	u8 ReadIO(u16 addr) const;
+
+	/**
+	* Catches the PPU up to the CPU's current cycle so that it can be safely accessed.
+	*/
+	inline void SyncPPU() const { ppu_.CatchUp(cpu_.GetElapsedCycles() * NES_PPU_CYCLES_PER_CPU_CYCLE); }
 };
 
@@ -1,270 +1,286 @@
 #include "NESCPU.h"
 
 
-#define OP(opName, opFunc, addrMode, cycleCount) \
-	NESCPUOpInfo(opName, true, &NESCPU::opFunc, NESCPUOpAddrMode::addrMode, cycleCount) \
+/**
+* List of every opcode ($00 - $FF) in order, in the form OP(name, executing function, addressing mode, cycle count).
+* UOP is used instead of OP for unofficial opcodes.
+*/
+#define NES_CPU_OPCODE_LIST(OP, UOP) \
+	OP(NES_OP_BRK_NAME, ExecuteOpBRK, IMPLIED_BRK, 7) \
+	OP(NES_OP_ORA_NAME, ExecuteOpORA, INDIRECT_X, 6) \
+	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0) \
+	UOP(NES_OP_SLO_NAME, ExecuteOpSLO, INDIRECT_X, 8) \
+	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE, 3) \
+	OP(NES_OP_ORA_NAME, ExecuteOpORA, ZEROPAGE, 3) \
+	OP(NES_OP_ASL_NAME, ExecuteOpASL, ZEROPAGE, 5) \
+	UOP(NES_OP_SLO_NAME, ExecuteOpSLO, ZEROPAGE, 5) \
+	OP(NES_OP_PHP_NAME, ExecuteOpPHP, IMPLIED, 3) \
+	OP(NES_OP_ORA_NAME, ExecuteOpORA, IMMEDIATE, 2) \
+	OP(NES_OP_ASL_NAME, ExecuteOpASL, ACCUMULATOR, 2) \
+	UOP(NES_OP_ANC_NAME, ExecuteOpANC, IMMEDIATE, 2) \
+	UOP(NES_OP_TOP_NAME, ExecuteOpNOP, ABSOLUTE, 4) \
+	OP(NES_OP_ORA_NAME, ExecuteOpORA, ABSOLUTE, 4) \
+	OP(NES_OP_ASL_NAME, ExecuteOpASL, ABSOLUTE, 6) \
+	UOP(NES_OP_SLO_NAME, ExecuteOpSLO, ABSOLUTE, 6) \
+	OP(NES_OP_BPL_NAME, ExecuteOpBPL, RELATIVE, 2) \
+	OP(NES_OP_ORA_NAME, ExecuteOpORA, INDIRECT_Y, 5) \
+	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0) \
+	UOP(NES_OP_SLO_NAME, ExecuteOpSLO, INDIRECT_Y, 8) \
+	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE_X, 4) \
+	OP(NES_OP_ORA_NAME, ExecuteOpORA, ZEROPAGE_X, 4) \
+	OP(NES_OP_ASL_NAME, ExecuteOpASL, ZEROPAGE_X, 6) \
+	UOP(NES_OP_SLO_NAME, ExecuteOpSLO, ZEROPAGE_X, 6) \
+	OP(NES_OP_CLC_NAME, ExecuteOpCLC, IMPLIED, 2) \
+	OP(NES_OP_ORA_NAME, ExecuteOpORA, ABSOLUTE_Y, 4) \
+	UOP(NES_OP_NOP_NAME, ExecuteOpNOP, IMPLIED, 2) \
+	UOP(NES_OP_SLO_NAME, ExecuteOpSLO, ABSOLUTE_Y, 7) \
+	UOP(NES_OP_TOP_NAME, ExecuteOpNOP, ABSOLUTE_X, 4) \
+	OP(NES_OP_ORA_NAME, ExecuteOpORA, ABSOLUTE_X, 4) \
+	OP(NES_OP_ASL_NAME, ExecuteOpASL, ABSOLUTE_X, 7) \
+	UOP(NES_OP_SLO_NAME, ExecuteOpSLO, ABSOLUTE_X, 7) \
+	OP(NES_OP_JSR_NAME, ExecuteOpJSR, ABSOLUTE, 6) \
+	OP(NES_OP_AND_NAME, ExecuteOpAND, INDIRECT_X, 6) \
+	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0) \
+	UOP(NES_OP_RLA_NAME, ExecuteOpRLA, INDIRECT_X, 8) \
+	OP(NES_OP_BIT_NAME, ExecuteOpBIT, ZEROPAGE, 3) \
+	OP(NES_OP_AND_NAME, ExecuteOpAND, ZEROPAGE, 3) \
+	OP(NES_OP_ROL_NAME, ExecuteOpROL, ZEROPAGE, 5) \
+	UOP(NES_OP_RLA_NAME, ExecuteOpRLA, ZEROPAGE, 5) \
+	OP(NES_OP_PLP_NAME, ExecuteOpPLP, IMPLIED, 4) \
+	OP(NES_OP_AND_NAME, ExecuteOpAND, IMMEDIATE, 2) \
+	OP(NES_OP_ROL_NAME, ExecuteOpROL, ACCUMULATOR, 2) \
+	UOP(NES_OP_ANC_NAME, ExecuteOpANC, IMMEDIATE, 2) \
+	OP(NES_OP_BIT_NAME, ExecuteOpBIT, ABSOLUTE, 4) \
+	OP(NES_OP_AND_NAME, ExecuteOpAND, ABSOLUTE, 4) \
+	OP(NES_OP_ROL_NAME, ExecuteOpROL, ABSOLUTE, 6) \
+	UOP(NES_OP_RLA_NAME, ExecuteOpRLA, ABSOLUTE, 6) \
+	OP(NES_OP_BMI_NAME, ExecuteOpBMI, RELATIVE, 2) \
+	OP(NES_OP_AND_NAME, ExecuteOpAND, INDIRECT_Y, 5) \
+	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0) \
+	UOP(NES_OP_RLA_NAME, ExecuteOpRLA, INDIRECT_Y, 8) \
+	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE_X, 4) \
+	OP(NES_OP_AND_NAME, ExecuteOpAND, ZEROPAGE_X, 4) \
+	OP(NES_OP_ROL_NAME, ExecuteOpROL, ZEROPAGE_X, 6) \
+	UOP(NES_OP_RLA_NAME, ExecuteOpRLA, ZEROPAGE_X, 6) \
+	OP(NES_OP_SEC_NAME, ExecuteOpSEC, IMPLIED, 2) \
+	OP(NES_OP_AND_NAME, ExecuteOpAND, ABSOLUTE_Y, 4) \
+	UOP(NES_OP_NOP_NAME, ExecuteOpNOP, IMPLIED, 2) \
+	UOP(NES_OP_RLA_NAME, ExecuteOpRLA, ABSOLUTE_Y, 7) \
+	UOP(NES_OP_TOP_NAME, ExecuteOpNOP, ABSOLUTE_X, 4) \
+	OP(NES_OP_AND_NAME, ExecuteOpAND, ABSOLUTE_X, 4) \
+	OP(NES_OP_ROL_NAME, ExecuteOpROL, ABSOLUTE_X, 7) \
+	UOP(NES_OP_RLA_NAME, ExecuteOpRLA, ABSOLUTE_X, 7) \
+	OP(NES_OP_RTI_NAME, ExecuteOpRTI, IMPLIED, 6) \
+	OP(NES_OP_EOR_NAME, ExecuteOpEOR, INDIRECT_X, 6) \
+	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0) \
+	UOP(NES_OP_SRE_NAME, ExecuteOpSRE, INDIRECT_X, 8) \
+	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE, 3) \
+	OP(NES_OP_EOR_NAME, ExecuteOpEOR, ZEROPAGE, 3) \
+	OP(NES_OP_LSR_NAME, ExecuteOpLSR, ZEROPAGE, 5) \
+	UOP(NES_OP_SRE_NAME, ExecuteOpSRE, ZEROPAGE, 5) \
+	OP(NES_OP_PHA_NAME, ExecuteOpPHA, IMPLIED, 3) \
+	OP(NES_OP_EOR_NAME, ExecuteOpEOR, IMMEDIATE, 2) \
+	OP(NES_OP_LSR_NAME, ExecuteOpLSR, ACCUMULATOR, 2) \
+	UOP(NES_OP_ASR_NAME, ExecuteOpASR, IMMEDIATE, 2) \
+	OP(NES_OP_JMP_NAME, ExecuteOpJMP, ABSOLUTE, 3) \
+	OP(NES_OP_EOR_NAME, ExecuteOpEOR, ABSOLUTE, 4) \
+	OP(NES_OP_LSR_NAME, ExecuteOpLSR, ABSOLUTE, 6) \
+	UOP(NES_OP_SRE_NAME, ExecuteOpSRE, ABSOLUTE, 6) \
+	OP(NES_OP_BVC_NAME, ExecuteOpBVC, RELATIVE, 2) \
+	OP(NES_OP_EOR_NAME, ExecuteOpEOR, INDIRECT_Y, 5) \
+	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0) \
+	UOP(NES_OP_SRE_NAME, ExecuteOpSRE, INDIRECT_Y, 8) \
+	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE_X, 4) \
+	OP(NES_OP_EOR_NAME, ExecuteOpEOR, ZEROPAGE_X, 4) \
+	OP(NES_OP_LSR_NAME, ExecuteOpLSR, ZEROPAGE_X, 6) \
+	UOP(NES_OP_SRE_NAME, ExecuteOpSRE, ZEROPAGE_X, 6) \
+	OP(NES_OP_CLI_NAME, ExecuteOpCLI, IMPLIED, 2) \
+	OP(NES_OP_EOR_NAME, ExecuteOpEOR, ABSOLUTE_Y, 4) \
+	UOP(NES_OP_NOP_NAME, ExecuteOpNOP, IMPLIED, 2) \
+	UOP(NES_OP_SRE_NAME, ExecuteOpSRE, ABSOLUTE_Y, 7) \
+	UOP(NES_OP_TOP_NAME, ExecuteOpNOP, ABSOLUTE_X, 4) \
+	OP(NES_OP_EOR_NAME, ExecuteOpEOR, ABSOLUTE_X, 4) \
+	OP(NES_OP_LSR_NAME, ExecuteOpLSR, ABSOLUTE_X, 7) \
+	UOP(NES_OP_SRE_NAME, ExecuteOpSRE, ABSOLUTE_X, 7) \
+	OP(NES_OP_RTS_NAME, ExecuteOpRTS, IMPLIED, 6) \
+	OP(NES_OP_ADC_NAME, ExecuteOpADC, INDIRECT_X, 6) \
+	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0) \
+	UOP(NES_OP_RRA_NAME, ExecuteOpRRA, INDIRECT_X, 8) \
+	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE, 3) \
+	OP(NES_OP_ADC_NAME, ExecuteOpADC, ZEROPAGE, 3) \
+	OP(NES_OP_ROR_NAME, ExecuteOpROR, ZEROPAGE, 5) \
+	UOP(NES_OP_RRA_NAME, ExecuteOpRRA, ZEROPAGE, 5) \
+	OP(NES_OP_PLA_NAME, ExecuteOpPLA, IMPLIED, 4) \
+	OP(NES_OP_ADC_NAME, ExecuteOpADC, IMMEDIATE, 2) \
+	OP(NES_OP_ROR_NAME, ExecuteOpROR, ACCUMULATOR, 2) \
+	UOP(NES_OP_ARR_NAME, ExecuteOpARR, IMMEDIATE, 2) \
+	OP(NES_OP_JMP_NAME, ExecuteOpJMP, INDIRECT, 5) \
+	OP(NES_OP_ADC_NAME, ExecuteOpADC, ABSOLUTE, 4) \
+	OP(NES_OP_ROR_NAME, ExecuteOpROR, ABSOLUTE, 6) \
+	UOP(NES_OP_RRA_NAME, ExecuteOpRRA, ABSOLUTE, 6) \
+	OP(NES_OP_BVS_NAME, ExecuteOpBVS, RELATIVE, 2) \
+	OP(NES_OP_ADC_NAME, ExecuteOpADC, INDIRECT_Y, 5) \
+	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0) \
+	UOP(NES_OP_RRA_NAME, ExecuteOpRRA, INDIRECT_Y, 8) \
+	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE_X, 4) \
+	OP(NES_OP_ADC_NAME, ExecuteOpADC, ZEROPAGE_X, 4) \
+	OP(NES_OP_ROR_NAME, ExecuteOpROR, ZEROPAGE_X, 6) \
+	UOP(NES_OP_RRA_NAME, ExecuteOpRRA, ZEROPAGE_X, 6) \
+	OP(NES_OP_SEI_NAME, ExecuteOpSEI, IMPLIED, 2) \
+	OP(NES_OP_ADC_NAME, ExecuteOpADC, ABSOLUTE_Y, 4) \
+	UOP(NES_OP_NOP_NAME, ExecuteOpNOP, IMPLIED, 2) \
+	UOP(NES_OP_RRA_NAME, ExecuteOpRRA, ABSOLUTE_Y, 7) \
+	UOP(NES_OP_TOP_NAME, ExecuteOpNOP, ABSOLUTE_X, 4) \
+	OP(NES_OP_ADC_NAME, ExecuteOpADC, ABSOLUTE_X, 4) \
+	OP(NES_OP_ROR_NAME, ExecuteOpROR, ABSOLUTE_X, 7) \
+	UOP(NES_OP_RRA_NAME, ExecuteOpRRA, ABSOLUTE_X, 7) \
+	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, IMMEDIATE, 2) \
+	OP(NES_OP_STA_NAME, ExecuteOpSTA, INDIRECT_X, 6) \
+	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, IMMEDIATE, 2) \
+	UOP(NES_OP_SAX_NAME, ExecuteOpSAX, INDIRECT_X, 6) \
+	OP(NES_OP_STY_NAME, ExecuteOpSTY, ZEROPAGE, 3) \
+	OP(NES_OP_STA_NAME, ExecuteOpSTA, ZEROPAGE, 3) \
+	OP(NES_OP_STX_NAME, ExecuteOpSTX, ZEROPAGE, 3) \
+	UOP(NES_OP_SAX_NAME, ExecuteOpSAX, ZEROPAGE, 3) \
+	OP(NES_OP_DEY_NAME, ExecuteOpDEY, IMPLIED, 2) \
+	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, IMMEDIATE, 2) \
+	OP(NES_OP_TXA_NAME, ExecuteOpTXA, IMPLIED, 2) \
+	UOP(NES_OP_XAA_NAME, ExecuteOpXAA, IMMEDIATE, 2) \
+	OP(NES_OP_STY_NAME, ExecuteOpSTY, ABSOLUTE, 4) \
+	OP(NES_OP_STA_NAME, ExecuteOpSTA, ABSOLUTE, 4) \
+	OP(NES_OP_STX_NAME, ExecuteOpSTX, ABSOLUTE, 4) \
+	UOP(NES_OP_SAX_NAME, ExecuteOpSAX, ABSOLUTE, 4) \
+	OP(NES_OP_BCC_NAME, ExecuteOpBCC, RELATIVE, 2) \
+	OP(NES_OP_STA_NAME, ExecuteOpSTA, INDIRECT_Y, 6) \
+	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0) \
+	UOP(NES_OP_AHX_NAME, ExecuteOpAHX, INDIRECT_Y, 6) \
+	OP(NES_OP_STY_NAME, ExecuteOpSTY, ZEROPAGE_X, 4) \
+	OP(NES_OP_STA_NAME, ExecuteOpSTA, ZEROPAGE_X, 4) \
+	OP(NES_OP_STX_NAME, ExecuteOpSTX, ZEROPAGE_Y, 4) \
+	UOP(NES_OP_SAX_NAME, ExecuteOpSAX, ZEROPAGE_Y, 4) \
+	OP(NES_OP_TYA_NAME, ExecuteOpTYA, IMPLIED, 2) \
+	OP(NES_OP_STA_NAME, ExecuteOpSTA, ABSOLUTE_Y, 5) \
+	OP(NES_OP_TXS_NAME, ExecuteOpTXS, IMPLIED, 2) \
+	UOP(NES_OP_TAS_NAME, ExecuteOpTAS, ABSOLUTE_Y, 5) \
+	UOP(NES_OP_SHY_NAME, ExecuteOpSHY, ABSOLUTE_X, 5) \
+	OP(NES_OP_STA_NAME, ExecuteOpSTA, ABSOLUTE_X, 5) \
+	UOP(NES_OP_SHX_NAME, ExecuteOpSHX, ABSOLUTE_Y, 5) \
+	UOP(NES_OP_AHX_NAME, ExecuteOpAHX, ABSOLUTE_Y, 5) \
+	OP(NES_OP_LDY_NAME, ExecuteOpLDY, IMMEDIATE, 2) \
+	OP(NES_OP_LDA_NAME, ExecuteOpLDA, INDIRECT_X, 6) \
+	OP(NES_OP_LDX_NAME, ExecuteOpLDX, IMMEDIATE, 2) \
+	UOP(NES_OP_LAX_NAME, ExecuteOpLAX, INDIRECT_X, 6) \
+	OP(NES_OP_LDY_NAME, ExecuteOpLDY, ZEROPAGE, 3) \
+	OP(NES_OP_LDA_NAME, ExecuteOpLDA, ZEROPAGE, 3) \
+	OP(NES_OP_LDX_NAME, ExecuteOpLDX, ZEROPAGE, 3) \
+	UOP(NES_OP_LAX_NAME, ExecuteOpLAX, ZEROPAGE, 3) \
+	OP(NES_OP_TAY_NAME, ExecuteOpTAY, IMPLIED, 2) \
+	OP(NES_OP_LDA_NAME, ExecuteOpLDA, IMMEDIATE, 2) \
+	OP(NES_OP_TAX_NAME, ExecuteOpTAX, IMPLIED, 2) \
+	UOP(NES_OP_LAX_NAME, ExecuteOpLAX, IMMEDIATE, 2) \
+	OP(NES_OP_LDY_NAME, ExecuteOpLDY, ABSOLUTE, 4) \
+	OP(NES_OP_LDA_NAME, ExecuteOpLDA, ABSOLUTE, 4) \
+	OP(NES_OP_LDX_NAME, ExecuteOpLDX, ABSOLUTE, 4) \
+	UOP(NES_OP_LAX_NAME, ExecuteOpLAX, ABSOLUTE, 4) \
+	OP(NES_OP_BCS_NAME, ExecuteOpBCS, RELATIVE, 2) \
+	OP(NES_OP_LDA_NAME, ExecuteOpLDA, INDIRECT_Y, 5) \
+	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0) \
+	UOP(NES_OP_LAX_NAME, ExecuteOpLAX, INDIRECT_Y, 5) \
+	OP(NES_OP_LDY_NAME, ExecuteOpLDY, ZEROPAGE_X, 4) \
+	OP(NES_OP_LDA_NAME, ExecuteOpLDA, ZEROPAGE_X, 4) \
+	OP(NES_OP_LDX_NAME, ExecuteOpLDX, ZEROPAGE_Y, 4) \
+	UOP(NES_OP_LAX_NAME, ExecuteOpLAX, ZEROPAGE_Y, 4) \
+	OP(NES_OP_CLV_NAME, ExecuteOpCLV, IMPLIED, 2) \
+	OP(NES_OP_LDA_NAME, ExecuteOpLDA, ABSOLUTE_Y, 4) \
+	OP(NES_OP_TSX_NAME, ExecuteOpTSX, IMPLIED, 2) \
+	UOP(NES_OP_LAS_NAME, ExecuteOpLAS, ABSOLUTE_Y, 4) \
+	OP(NES_OP_LDY_NAME, ExecuteOpLDY, ABSOLUTE_X, 4) \
+	OP(NES_OP_LDA_NAME, ExecuteOpLDA, ABSOLUTE_X, 4) \
+	OP(NES_OP_LDX_NAME, ExecuteOpLDX, ABSOLUTE_Y, 4) \
+	UOP(NES_OP_LAX_NAME, ExecuteOpLAX, ABSOLUTE_Y, 4) \
+	OP(NES_OP_CPY_NAME, ExecuteOpCPY, IMMEDIATE, 2) \
+	OP(NES_OP_CMP_NAME, ExecuteOpCMP, INDIRECT_X, 6) \
+	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, IMMEDIATE, 2) \
+	UOP(NES_OP_DCP_NAME, ExecuteOpDCP, INDIRECT_X, 8) \
+	OP(NES_OP_CPY_NAME, ExecuteOpCPY, ZEROPAGE, 3) \
+	OP(NES_OP_CMP_NAME, ExecuteOpCMP, ZEROPAGE, 3) \
+	OP(NES_OP_DEC_NAME, ExecuteOpDEC, ZEROPAGE, 5) \
+	UOP(NES_OP_DCP_NAME, ExecuteOpDCP, ZEROPAGE, 5) \
+	OP(NES_OP_INY_NAME, ExecuteOpINY, IMPLIED, 2) \
+	OP(NES_OP_CMP_NAME, ExecuteOpCMP, IMMEDIATE, 2) \
+	OP(NES_OP_DEX_NAME, ExecuteOpDEX, IMPLIED, 2) \
+	UOP(NES_OP_AXS_NAME, ExecuteOpAXS, IMMEDIATE, 2) \
+	OP(NES_OP_CPY_NAME, ExecuteOpCPY, ABSOLUTE, 4) \
+	OP(NES_OP_CMP_NAME, ExecuteOpCMP, ABSOLUTE, 4) \
+	OP(NES_OP_DEC_NAME, ExecuteOpDEC, ABSOLUTE, 6) \
+	UOP(NES_OP_DCP_NAME, ExecuteOpDCP, ABSOLUTE, 6) \
+	OP(NES_OP_BNE_NAME, ExecuteOpBNE, RELATIVE, 2) \
+	OP(NES_OP_CMP_NAME, ExecuteOpCMP, INDIRECT_Y, 5) \
+	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0) \
+	UOP(NES_OP_DCP_NAME, ExecuteOpDCP, INDIRECT_Y, 8) \
+	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE_X, 4) \
+	OP(NES_OP_CMP_NAME, ExecuteOpCMP, ZEROPAGE_X, 4) \
+	OP(NES_OP_DEC_NAME, ExecuteOpDEC, ZEROPAGE_X, 6) \
+	UOP(NES_OP_DCP_NAME, ExecuteOpDCP, ZEROPAGE_X, 6) \
+	OP(NES_OP_CLD_NAME, ExecuteOpCLD, IMPLIED, 2) \
+	OP(NES_OP_CMP_NAME, ExecuteOpCMP, ABSOLUTE_Y, 4) \
+	UOP(NES_OP_NOP_NAME, ExecuteOpNOP, IMPLIED, 2) \
+	UOP(NES_OP_DCP_NAME, ExecuteOpDCP, ABSOLUTE_Y, 7) \
+	UOP(NES_OP_TOP_NAME, ExecuteOpNOP, ABSOLUTE_X, 4) \
+	OP(NES_OP_CMP_NAME, ExecuteOpCMP, ABSOLUTE_X, 4) \
+	OP(NES_OP_DEC_NAME, ExecuteOpDEC, ABSOLUTE_X, 7) \
+	UOP(NES_OP_DCP_NAME, ExecuteOpDCP, ABSOLUTE_X, 7) \
+	OP(NES_OP_CPX_NAME, ExecuteOpCPX, IMMEDIATE, 2) \
+	OP(NES_OP_SBC_NAME, ExecuteOpSBC, INDIRECT_X, 6) \
+	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, IMMEDIATE, 2) \
+	UOP(NES_OP_ISC_NAME, ExecuteOpISC, INDIRECT_X, 8) \
+	OP(NES_OP_CPX_NAME, ExecuteOpCPX, ZEROPAGE, 3) \
+	OP(NES_OP_SBC_NAME, ExecuteOpSBC, ZEROPAGE, 3) \
+	OP(NES_OP_INC_NAME, ExecuteOpINC, ZEROPAGE, 5) \
+	UOP(NES_OP_ISC_NAME, ExecuteOpISC, ZEROPAGE, 5) \
+	OP(NES_OP_INX_NAME, ExecuteOpINX, IMPLIED, 2) \
+	OP(NES_OP_SBC_NAME, ExecuteOpSBC, IMMEDIATE, 2) \
+	OP(NES_OP_NOP_NAME, ExecuteOpNOP, IMPLIED, 2) \
+	UOP(NES_OP_SBC_NAME, ExecuteOpSBC, IMMEDIATE, 2) \
+	OP(NES_OP_CPX_NAME, ExecuteOpCPX, ABSOLUTE, 4) \
+	OP(NES_OP_SBC_NAME, ExecuteOpSBC, ABSOLUTE, 4) \
+	OP(NES_OP_INC_NAME, ExecuteOpINC, ABSOLUTE, 6) \
+	UOP(NES_OP_ISC_NAME, ExecuteOpISC, ABSOLUTE, 6) \
+	OP(NES_OP_BEQ_NAME, ExecuteOpBEQ, RELATIVE, 2) \
+	OP(NES_OP_SBC_NAME, ExecuteOpSBC, INDIRECT_Y, 5) \
+	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0) \
+	UOP(NES_OP_ISC_NAME, ExecuteOpISC, INDIRECT_Y, 8) \
+	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE_X, 4) \
+	OP(NES_OP_SBC_NAME, ExecuteOpSBC, ZEROPAGE_X, 4) \
+	OP(NES_OP_INC_NAME, ExecuteOpINC, ZEROPAGE_X, 6) \
+	UOP(NES_OP_ISC_NAME, ExecuteOpISC, ZEROPAGE_X, 6) \
+	OP(NES_OP_SED_NAME, ExecuteOpSED, IMPLIED, 2) \
+	OP(NES_OP_SBC_NAME, ExecuteOpSBC, ABSOLUTE_Y, 4) \
+	UOP(NES_OP_NOP_NAME, ExecuteOpNOP, IMPLIED, 2) \
+	UOP(NES_OP_ISC_NAME, ExecuteOpISC, ABSOLUTE_Y, 7) \
+	UOP(NES_OP_TOP_NAME, ExecuteOpNOP, ABSOLUTE_X, 4) \
+	OP(NES_OP_SBC_NAME, ExecuteOpSBC, ABSOLUTE_X, 4) \
+	OP(NES_OP_INC_NAME, ExecuteOpINC, ABSOLUTE_X, 7) \
+	UOP(NES_OP_ISC_NAME, ExecuteOpISC, ABSOLUTE_X, 7)
 
 
-#define UOP(opName, opFunc, addrMode, cycleCount) \
-	NESCPUOpInfo(opName, false, &NESCPU::opFunc, NESCPUOpAddrMode::addrMode, cycleCount) \
+#define OP_INFO(opName, opFunc, addrMode, cycleCount) \
+	NESCPUOpInfo(opName, true, NESCPUOpAddrMode::addrMode, cycleCount),
 
+#define UOP_INFO(opName, opFunc, addrMode, cycleCount) \
+	NESCPUOpInfo(opName, false, NESCPUOpAddrMode::addrMode, cycleCount),
 
-// Opcode mappings.
-std::array<NESCPUOpInfo, 0x100> NESCPU::opInfos_ = {
-	OP(NES_OP_BRK_NAME, ExecuteOpBRK, IMPLIED_BRK, 7),
-	OP(NES_OP_ORA_NAME, ExecuteOpORA, INDIRECT_X, 6),
-	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0),
-	UOP(NES_OP_SLO_NAME, ExecuteOpSLO, INDIRECT_X, 8),
-	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE, 3),
-	OP(NES_OP_ORA_NAME, ExecuteOpORA, ZEROPAGE, 3),
-	OP(NES_OP_ASL_NAME, ExecuteOpASL, ZEROPAGE, 5),
-	UOP(NES_OP_SLO_NAME, ExecuteOpSLO, ZEROPAGE, 5),
-	OP(NES_OP_PHP_NAME, ExecuteOpPHP, IMPLIED, 3),
-	OP(NES_OP_ORA_NAME, ExecuteOpORA, IMMEDIATE, 2),
-	OP(NES_OP_ASL_NAME, ExecuteOpASL, ACCUMULATOR, 2),
-	UOP(NES_OP_ANC_NAME, ExecuteOpANC, IMMEDIATE, 2),
-	UOP(NES_OP_TOP_NAME, ExecuteOpNOP, ABSOLUTE, 4),
-	OP(NES_OP_ORA_NAME, ExecuteOpORA, ABSOLUTE, 4),
-	OP(NES_OP_ASL_NAME, ExecuteOpASL, ABSOLUTE, 6),
-	UOP(NES_OP_SLO_NAME, ExecuteOpSLO, ABSOLUTE, 6),
-	OP(NES_OP_BPL_NAME, ExecuteOpBPL, RELATIVE, 2),
-	OP(NES_OP_ORA_NAME, ExecuteOpORA, INDIRECT_Y, 5),
-	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0),
-	UOP(NES_OP_SLO_NAME, ExecuteOpSLO, INDIRECT_Y, 8),
-	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE_X, 4),
-	OP(NES_OP_ORA_NAME, ExecuteOpORA, ZEROPAGE_X, 4),
-	OP(NES_OP_ASL_NAME, ExecuteOpASL, ZEROPAGE_X, 6),
-	UOP(NES_OP_SLO_NAME, ExecuteOpSLO, ZEROPAGE_X, 6),
-	OP(NES_OP_CLC_NAME, ExecuteOpCLC, IMPLIED, 2),
-	OP(NES_OP_ORA_NAME, ExecuteOpORA, ABSOLUTE_Y, 4),
-	UOP(NES_OP_NOP_NAME, ExecuteOpNOP, IMPLIED, 2),
-	UOP(NES_OP_SLO_NAME, ExecuteOpSLO, ABSOLUTE_Y, 7),
-	UOP(NES_OP_TOP_NAME, ExecuteOpNOP, ABSOLUTE_X, 4),
-	OP(NES_OP_ORA_NAME, ExecuteOpORA, ABSOLUTE_X, 4),
-	OP(NES_OP_ASL_NAME, ExecuteOpASL, ABSOLUTE_X, 7),
-	UOP(NES_OP_SLO_NAME, ExecuteOpSLO, ABSOLUTE_X, 7),
-	OP(NES_OP_JSR_NAME, ExecuteOpJSR, ABSOLUTE, 6),
-	OP(NES_OP_AND_NAME, ExecuteOpAND, INDIRECT_X, 6),
-	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0),
-	UOP(NES_OP_RLA_NAME, ExecuteOpRLA, INDIRECT_X, 8),
-	OP(NES_OP_BIT_NAME, ExecuteOpBIT, ZEROPAGE, 3),
-	OP(NES_OP_AND_NAME, ExecuteOpAND, ZEROPAGE, 3),
-	OP(NES_OP_ROL_NAME, ExecuteOpROL, ZEROPAGE, 5),
-	UOP(NES_OP_RLA_NAME, ExecuteOpRLA, ZEROPAGE, 5),
-	OP(NES_OP_PLP_NAME, ExecuteOpPLP, IMPLIED, 4),
-	OP(NES_OP_AND_NAME, ExecuteOpAND, IMMEDIATE, 2),
-	OP(NES_OP_ROL_NAME, ExecuteOpROL, ACCUMULATOR, 2),
-	UOP(NES_OP_ANC_NAME, ExecuteOpANC, IMMEDIATE, 2),
-	OP(NES_OP_BIT_NAME, ExecuteOpBIT, ABSOLUTE, 4),
-	OP(NES_OP_AND_NAME, ExecuteOpAND, ABSOLUTE, 4),
-	OP(NES_OP_ROL_NAME, ExecuteOpROL, ABSOLUTE, 6),
-	UOP(NES_OP_RLA_NAME, ExecuteOpRLA, ABSOLUTE, 6),
-	OP(NES_OP_BMI_NAME, ExecuteOpBMI, RELATIVE, 2),
-	OP(NES_OP_AND_NAME, ExecuteOpAND, INDIRECT_Y, 5),
-	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0),
-	UOP(NES_OP_RLA_NAME, ExecuteOpRLA, INDIRECT_Y, 8),
-	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE_X, 4),
-	OP(NES_OP_AND_NAME, ExecuteOpAND, ZEROPAGE_X, 4),
-	OP(NES_OP_ROL_NAME, ExecuteOpROL, ZEROPAGE_X, 6),
-	UOP(NES_OP_RLA_NAME, ExecuteOpRLA, ZEROPAGE_X, 6),
-	OP(NES_OP_SEC_NAME, ExecuteOpSEC, IMPLIED, 2),
-	OP(NES_OP_AND_NAME, ExecuteOpAND, ABSOLUTE_Y, 4),
-	UOP(NES_OP_NOP_NAME, ExecuteOpNOP, IMPLIED, 2),
-	UOP(NES_OP_RLA_NAME, ExecuteOpRLA, ABSOLUTE_Y, 7),
-	UOP(NES_OP_TOP_NAME, ExecuteOpNOP, ABSOLUTE_X, 4),
-	OP(NES_OP_AND_NAME, ExecuteOpAND, ABSOLUTE_X, 4),
-	OP(NES_OP_ROL_NAME, ExecuteOpROL, ABSOLUTE_X, 7),
-	UOP(NES_OP_RLA_NAME, ExecuteOpRLA, ABSOLUTE_X, 7),
-	OP(NES_OP_RTI_NAME, ExecuteOpRTI, IMPLIED, 6),
-	OP(NES_OP_EOR_NAME, ExecuteOpEOR, INDIRECT_X, 6),
-	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0),
-	UOP(NES_OP_SRE_NAME, ExecuteOpSRE, INDIRECT_X, 8),
-	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE, 3),
-	OP(NES_OP_EOR_NAME, ExecuteOpEOR, ZEROPAGE, 3),
-	OP(NES_OP_LSR_NAME, ExecuteOpLSR, ZEROPAGE, 5),
-	UOP(NES_OP_SRE_NAME, ExecuteOpSRE, ZEROPAGE, 5),
-	OP(NES_OP_PHA_NAME, ExecuteOpPHA, IMPLIED, 3),
-	OP(NES_OP_EOR_NAME, ExecuteOpEOR, IMMEDIATE, 2),
-	OP(NES_OP_LSR_NAME, ExecuteOpLSR, ACCUMULATOR, 2),
-	UOP(NES_OP_ASR_NAME, ExecuteOpASR, IMMEDIATE, 2),
-	OP(NES_OP_JMP_NAME, ExecuteOpJMP, ABSOLUTE, 3),
-	OP(NES_OP_EOR_NAME, ExecuteOpEOR, ABSOLUTE, 4),
-	OP(NES_OP_LSR_NAME, ExecuteOpLSR, ABSOLUTE, 6),
-	UOP(NES_OP_SRE_NAME, ExecuteOpSRE, ABSOLUTE, 6),
-	OP(NES_OP_BVC_NAME, ExecuteOpBVC, RELATIVE, 2),
-	OP(NES_OP_EOR_NAME, ExecuteOpEOR, INDIRECT_Y, 5),
-	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0),
-	UOP(NES_OP_SRE_NAME, ExecuteOpSRE, INDIRECT_Y, 8),
-	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE_X, 4),
-	OP(NES_OP_EOR_NAME, ExecuteOpEOR, ZEROPAGE_X, 4),
-	OP(NES_OP_LSR_NAME, ExecuteOpLSR, ZEROPAGE_X, 6),
-	UOP(NES_OP_SRE_NAME, ExecuteOpSRE, ZEROPAGE_X, 6),
-	OP(NES_OP_CLI_NAME, ExecuteOpCLI, IMPLIED, 2),
-	OP(NES_OP_EOR_NAME, ExecuteOpEOR, ABSOLUTE_Y, 4),
-	UOP(NES_OP_NOP_NAME, ExecuteOpNOP, IMPLIED, 2),
-	UOP(NES_OP_SRE_NAME, ExecuteOpSRE, ABSOLUTE_Y, 7),
-	UOP(NES_OP_TOP_NAME, ExecuteOpNOP, ABSOLUTE_X, 4),
-	OP(NES_OP_EOR_NAME, ExecuteOpEOR, ABSOLUTE_X, 4),
-	OP(NES_OP_LSR_NAME, ExecuteOpLSR, ABSOLUTE_X, 7),
-	UOP(NES_OP_SRE_NAME, ExecuteOpSRE, ABSOLUTE_X, 7),
-	OP(NES_OP_RTS_NAME, ExecuteOpRTS, IMPLIED, 6),
-	OP(NES_OP_ADC_NAME, ExecuteOpADC, INDIRECT_X, 6),
-	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0),
-	UOP(NES_OP_RRA_NAME, ExecuteOpRRA, INDIRECT_X, 8),
-	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE, 3),
-	OP(NES_OP_ADC_NAME, ExecuteOpADC, ZEROPAGE, 3),
-	OP(NES_OP_ROR_NAME, ExecuteOpROR, ZEROPAGE, 5),
-	UOP(NES_OP_RRA_NAME, ExecuteOpRRA, ZEROPAGE, 5),
-	OP(NES_OP_PLA_NAME, ExecuteOpPLA, IMPLIED, 4),
-	OP(NES_OP_ADC_NAME, ExecuteOpADC, IMMEDIATE, 2),
-	OP(NES_OP_ROR_NAME, ExecuteOpROR, ACCUMULATOR, 2),
-	UOP(NES_OP_ARR_NAME, ExecuteOpARR, IMMEDIATE, 2),
-	OP(NES_OP_JMP_NAME, ExecuteOpJMP, INDIRECT, 5),
-	OP(NES_OP_ADC_NAME, ExecuteOpADC, ABSOLUTE, 4),
-	OP(NES_OP_ROR_NAME, ExecuteOpROR, ABSOLUTE, 6),
-	UOP(NES_OP_RRA_NAME, ExecuteOpRRA, ABSOLUTE, 6),
-	OP(NES_OP_BVS_NAME, ExecuteOpBVS, RELATIVE, 2),
-	OP(NES_OP_ADC_NAME, ExecuteOpADC, INDIRECT_Y, 5),
-	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0),
-	UOP(NES_OP_RRA_NAME, ExecuteOpRRA, INDIRECT_Y, 8),
-	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE_X, 4),
-	OP(NES_OP_ADC_NAME, ExecuteOpADC, ZEROPAGE_X, 4),
-	OP(NES_OP_ROR_NAME, ExecuteOpROR, ZEROPAGE_X, 6),
-	UOP(NES_OP_RRA_NAME, ExecuteOpRRA, ZEROPAGE_X, 6),
-	OP(NES_OP_SEI_NAME, ExecuteOpSEI, IMPLIED, 2),
-	OP(NES_OP_ADC_NAME, ExecuteOpADC, ABSOLUTE_Y, 4),
-	UOP(NES_OP_NOP_NAME, ExecuteOpNOP, IMPLIED, 2),
-	UOP(NES_OP_RRA_NAME, ExecuteOpRRA, ABSOLUTE_Y, 7),
-	UOP(NES_OP_TOP_NAME, ExecuteOpNOP, ABSOLUTE_X, 4),
-	OP(NES_OP_ADC_NAME, ExecuteOpADC, ABSOLUTE_X, 4),
-	OP(NES_OP_ROR_NAME, ExecuteOpROR, ABSOLUTE_X, 7),
-	UOP(NES_OP_RRA_NAME, ExecuteOpRRA, ABSOLUTE_X, 7),
-	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, IMMEDIATE, 2),
-	OP(NES_OP_STA_NAME, ExecuteOpSTA, INDIRECT_X, 6),
-	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, IMMEDIATE, 2),
-	UOP(NES_OP_SAX_NAME, ExecuteOpSAX, INDIRECT_X, 6),
-	OP(NES_OP_STY_NAME, ExecuteOpSTY, ZEROPAGE, 3),
-	OP(NES_OP_STA_NAME, ExecuteOpSTA, ZEROPAGE, 3),
-	OP(NES_OP_STX_NAME, ExecuteOpSTX, ZEROPAGE, 3),
-	UOP(NES_OP_SAX_NAME, ExecuteOpSAX, ZEROPAGE, 3),
-	OP(NES_OP_DEY_NAME, ExecuteOpDEY, IMPLIED, 2),
-	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, IMMEDIATE, 2),
-	OP(NES_OP_TXA_NAME, ExecuteOpTXA, IMPLIED, 2),
-	UOP(NES_OP_XAA_NAME, ExecuteOpXAA, IMMEDIATE, 2),
-	OP(NES_OP_STY_NAME, ExecuteOpSTY, ABSOLUTE, 4),
-	OP(NES_OP_STA_NAME, ExecuteOpSTA, ABSOLUTE, 4),
-	OP(NES_OP_STX_NAME, ExecuteOpSTX, ABSOLUTE, 4),
-	UOP(NES_OP_SAX_NAME, ExecuteOpSAX, ABSOLUTE, 4),
-	OP(NES_OP_BCC_NAME, ExecuteOpBCC, RELATIVE, 2),
-	OP(NES_OP_STA_NAME, ExecuteOpSTA, INDIRECT_Y, 6),
-	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0),
-	UOP(NES_OP_AHX_NAME, ExecuteOpAHX, INDIRECT_Y, 6),
-	OP(NES_OP_STY_NAME, ExecuteOpSTY, ZEROPAGE_X, 4),
-	OP(NES_OP_STA_NAME, ExecuteOpSTA, ZEROPAGE_X, 4),
-	OP(NES_OP_STX_NAME, ExecuteOpSTX, ZEROPAGE_Y, 4),
-	UOP(NES_OP_SAX_NAME, ExecuteOpSAX, ZEROPAGE_Y, 4),
-	OP(NES_OP_TYA_NAME, ExecuteOpTYA, IMPLIED, 2),
-	OP(NES_OP_STA_NAME, ExecuteOpSTA, ABSOLUTE_Y, 5),
-	OP(NES_OP_TXS_NAME, ExecuteOpTXS, IMPLIED, 2),
-	UOP(NES_OP_TAS_NAME, ExecuteOpTAS, ABSOLUTE_Y, 5),
-	UOP(NES_OP_SHY_NAME, ExecuteOpSHY, ABSOLUTE_X, 5),
-	OP(NES_OP_STA_NAME, ExecuteOpSTA, ABSOLUTE_X, 5),
-	UOP(NES_OP_SHX_NAME, ExecuteOpSHX, ABSOLUTE_Y, 5),
-	UOP(NES_OP_AHX_NAME, ExecuteOpAHX, ABSOLUTE_Y, 5),
-	OP(NES_OP_LDY_NAME, ExecuteOpLDY, IMMEDIATE, 2),
-	OP(NES_OP_LDA_NAME, ExecuteOpLDA, INDIRECT_X, 6),
-	OP(NES_OP_LDX_NAME, ExecuteOpLDX, IMMEDIATE, 2),
-	UOP(NES_OP_LAX_NAME, ExecuteOpLAX, INDIRECT_X, 6),
-	OP(NES_OP_LDY_NAME, ExecuteOpLDY, ZEROPAGE, 3),
-	OP(NES_OP_LDA_NAME, ExecuteOpLDA, ZEROPAGE, 3),
-	OP(NES_OP_LDX_NAME, ExecuteOpLDX, ZEROPAGE, 3),
-	UOP(NES_OP_LAX_NAME, ExecuteOpLAX, ZEROPAGE, 3),
-	OP(NES_OP_TAY_NAME, ExecuteOpTAY, IMPLIED, 2),
-	OP(NES_OP_LDA_NAME, ExecuteOpLDA, IMMEDIATE, 2),
-	OP(NES_OP_TAX_NAME, ExecuteOpTAX, IMPLIED, 2),
-	UOP(NES_OP_LAX_NAME, ExecuteOpLAX, IMMEDIATE, 2),
-	OP(NES_OP_LDY_NAME, ExecuteOpLDY, ABSOLUTE, 4),
-	OP(NES_OP_LDA_NAME, ExecuteOpLDA, ABSOLUTE, 4),
-	OP(NES_OP_LDX_NAME, ExecuteOpLDX, ABSOLUTE, 4),
-	UOP(NES_OP_LAX_NAME, ExecuteOpLAX, ABSOLUTE, 4),
-	OP(NES_OP_BCS_NAME, ExecuteOpBCS, RELATIVE, 2),
-	OP(NES_OP_LDA_NAME, ExecuteOpLDA, INDIRECT_Y, 5),
-	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0),
-	UOP(NES_OP_LAX_NAME, ExecuteOpLAX, INDIRECT_Y, 5),
-	OP(NES_OP_LDY_NAME, ExecuteOpLDY, ZEROPAGE_X, 4),
-	OP(NES_OP_LDA_NAME, ExecuteOpLDA, ZEROPAGE_X, 4),
-	OP(NES_OP_LDX_NAME, ExecuteOpLDX, ZEROPAGE_Y, 4),
-	UOP(NES_OP_LAX_NAME, ExecuteOpLAX, ZEROPAGE_Y, 4),
-	OP(NES_OP_CLV_NAME, ExecuteOpCLV, IMPLIED, 2),
-	OP(NES_OP_LDA_NAME, ExecuteOpLDA, ABSOLUTE_Y, 4),
-	OP(NES_OP_TSX_NAME, ExecuteOpTSX, IMPLIED, 2),
-	UOP(NES_OP_LAS_NAME, ExecuteOpLAS, ABSOLUTE_Y, 4),
-	OP(NES_OP_LDY_NAME, ExecuteOpLDY, ABSOLUTE_X, 4),
-	OP(NES_OP_LDA_NAME, ExecuteOpLDA, ABSOLUTE_X, 4),
-	OP(NES_OP_LDX_NAME, ExecuteOpLDX, ABSOLUTE_Y, 4),
-	UOP(NES_OP_LAX_NAME, ExecuteOpLAX, ABSOLUTE_Y, 4),
-	OP(NES_OP_CPY_NAME, ExecuteOpCPY, IMMEDIATE, 2),
-	OP(NES_OP_CMP_NAME, ExecuteOpCMP, INDIRECT_X, 6),
-	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, IMMEDIATE, 2),
-	UOP(NES_OP_DCP_NAME, ExecuteOpDCP, INDIRECT_X, 8),
-	OP(NES_OP_CPY_NAME, ExecuteOpCPY, ZEROPAGE, 3),
-	OP(NES_OP_CMP_NAME, ExecuteOpCMP, ZEROPAGE, 3),
-	OP(NES_OP_DEC_NAME, ExecuteOpDEC, ZEROPAGE, 5),
-	UOP(NES_OP_DCP_NAME, ExecuteOpDCP, ZEROPAGE, 5),
-	OP(NES_OP_INY_NAME, ExecuteOpINY, IMPLIED, 2),
-	OP(NES_OP_CMP_NAME, ExecuteOpCMP, IMMEDIATE, 2),
-	OP(NES_OP_DEX_NAME, ExecuteOpDEX, IMPLIED, 2),
-	UOP(NES_OP_AXS_NAME, ExecuteOpAXS, IMMEDIATE, 2),
-	OP(NES_OP_CPY_NAME, ExecuteOpCPY, ABSOLUTE, 4),
-	OP(NES_OP_CMP_NAME, ExecuteOpCMP, ABSOLUTE, 4),
-	OP(NES_OP_DEC_NAME, ExecuteOpDEC, ABSOLUTE, 6),
-	UOP(NES_OP_DCP_NAME, ExecuteOpDCP, ABSOLUTE, 6),
-	OP(NES_OP_BNE_NAME, ExecuteOpBNE, RELATIVE, 2),
-	OP(NES_OP_CMP_NAME, ExecuteOpCMP, INDIRECT_Y, 5),
-	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0),
-	UOP(NES_OP_DCP_NAME, ExecuteOpDCP, INDIRECT_Y, 8),
-	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE_X, 4),
-	OP(NES_OP_CMP_NAME, ExecuteOpCMP, ZEROPAGE_X, 4),
-	OP(NES_OP_DEC_NAME, ExecuteOpDEC, ZEROPAGE_X, 6),
-	UOP(NES_OP_DCP_NAME, ExecuteOpDCP, ZEROPAGE_X, 6),
-	OP(NES_OP_CLD_NAME, ExecuteOpCLD, IMPLIED, 2),
-	OP(NES_OP_CMP_NAME, ExecuteOpCMP, ABSOLUTE_Y, 4),
-	UOP(NES_OP_NOP_NAME, ExecuteOpNOP, IMPLIED, 2),
-	UOP(NES_OP_DCP_NAME, ExecuteOpDCP, ABSOLUTE_Y, 7),
-	UOP(NES_OP_TOP_NAME, ExecuteOpNOP, ABSOLUTE_X, 4),
-	OP(NES_OP_CMP_NAME, ExecuteOpCMP, ABSOLUTE_X, 4),
-	OP(NES_OP_DEC_NAME, ExecuteOpDEC, ABSOLUTE_X, 7),
-	UOP(NES_OP_DCP_NAME, ExecuteOpDCP, ABSOLUTE_X, 7),
-	OP(NES_OP_CPX_NAME, ExecuteOpCPX, IMMEDIATE, 2),
-	OP(NES_OP_SBC_NAME, ExecuteOpSBC, INDIRECT_X, 6),
-	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, IMMEDIATE, 2),
-	UOP(NES_OP_ISC_NAME, ExecuteOpISC, INDIRECT_X, 8),
-	OP(NES_OP_CPX_NAME, ExecuteOpCPX, ZEROPAGE, 3),
-	OP(NES_OP_SBC_NAME, ExecuteOpSBC, ZEROPAGE, 3),
-	OP(NES_OP_INC_NAME, ExecuteOpINC, ZEROPAGE, 5),
-	UOP(NES_OP_ISC_NAME, ExecuteOpISC, ZEROPAGE, 5),
-	OP(NES_OP_INX_NAME, ExecuteOpINX, IMPLIED, 2),
-	OP(NES_OP_SBC_NAME, ExecuteOpSBC, IMMEDIATE, 2),
-	OP(NES_OP_NOP_NAME, ExecuteOpNOP, IMPLIED, 2),
-	UOP(NES_OP_SBC_NAME, ExecuteOpSBC, IMMEDIATE, 2),
-	OP(NES_OP_CPX_NAME, ExecuteOpCPX, ABSOLUTE, 4),
-	OP(NES_OP_SBC_NAME, ExecuteOpSBC, ABSOLUTE, 4),
-	OP(NES_OP_INC_NAME, ExecuteOpINC, ABSOLUTE, 6),
-	UOP(NES_OP_ISC_NAME, ExecuteOpISC, ABSOLUTE, 6),
-	OP(NES_OP_BEQ_NAME, ExecuteOpBEQ, RELATIVE, 2),
-	OP(NES_OP_SBC_NAME, ExecuteOpSBC, INDIRECT_Y, 5),
-	UOP(NES_OP_KIL_NAME, ExecuteOpKIL, IMPLIED, 0),
-	UOP(NES_OP_ISC_NAME, ExecuteOpISC, INDIRECT_Y, 8),
-	UOP(NES_OP_DOP_NAME, ExecuteOpNOP, ZEROPAGE_X, 4),
-	OP(NES_OP_SBC_NAME, ExecuteOpSBC, ZEROPAGE_X, 4),
-	OP(NES_OP_INC_NAME, ExecuteOpINC, ZEROPAGE_X, 6),
-	UOP(NES_OP_ISC_NAME, ExecuteOpISC, ZEROPAGE_X, 6),
-	OP(NES_OP_SED_NAME, ExecuteOpSED, IMPLIED, 2),
-	OP(NES_OP_SBC_NAME, ExecuteOpSBC, ABSOLUTE_Y, 4),
-	UOP(NES_OP_NOP_NAME, ExecuteOpNOP, IMPLIED, 2),
-	UOP(NES_OP_ISC_NAME, ExecuteOpISC, ABSOLUTE_Y, 7),
-	UOP(NES_OP_TOP_NAME, ExecuteOpNOP, ABSOLUTE_X, 4),
-	OP(NES_OP_SBC_NAME, ExecuteOpSBC, ABSOLUTE_X, 4),
-	OP(NES_OP_INC_NAME, ExecuteOpINC, ABSOLUTE_X, 7),
-	UOP(NES_OP_ISC_NAME, ExecuteOpISC, ABSOLUTE_X, 7)
-};
\ No newline at end of file
+#define OP_EXEC_FUNC(opName, opFunc, addrMode, cycleCount) \
+	&NESCPU::ExecuteOp<&NESCPU::opFunc, NESCPUOpAddrMode::addrMode>,
+
+
+// Opcode info.
+// @NOTE: NESCPUOpInfo has a constexpr constructor, so this is initialized at compile time.
+const std::array<NESCPUOpInfo, 0x100> NESCPU::opInfos_ = { {
+	NES_CPU_OPCODE_LIST(OP_INFO, UOP_INFO)
+} };
+
+// Opcode executing functions.
+const std::array<NESOpExecFuncPointer, 0x100> NESCPU::opExecFuncs_ = { {
+	NES_CPU_OPCODE_LIST(OP_EXEC_FUNC, OP_EXEC_FUNC)
+} };
@@ -0,0 +1,85 @@
+#include "NESCPUTrace.h"
+
+#include <cstring>
+#include <iomanip>
+
+#include "NESCPU.h"
+
+
+NESCPUTraceBuffer::NESCPUTraceBuffer(std::size_t capacity) :
+records_(capacity),
+nextIndex_(0),
+size_(0)
+{
+	assert(capacity > 0);
+}
+
+
+NESCPUTraceBuffer::~NESCPUTraceBuffer()
+{
+}
+
+
+void NESCPUTraceBuffer::Clear()
+{
+	nextIndex_ = 0;
+	size_ = 0;
+}
+
+
+void NESCPUTraceBuffer::ExportNestestLog(std::ostream& os) const
+{
+	const auto flags = os.flags();
+	const auto fill = os.fill('0');
+	os << std::uppercase << std::hex;
+
+	for (std::size_t i = 0; i < size_; ++i)
+	{
+		const auto& record = GetRecord(i);
+		const auto& opInfo = NESCPU::GetOpInfo(record.opBytes[0]);
+
+		// Address and bytes of the instruction.
+		os << std::setw(4) << record.PC << "  ";
+		for (u8 j = 0; j < 3; ++j)
+		{
+			if (j < record.opSize)
+				os << std::setw(2) << +record.opBytes[j] << ' ';
+			else
+				os << "   ";
+		}
+
+		// Unofficial ops are marked with a *.
+		os << (opInfo.isOfficialOp ? ' ' : '*');
+
+		// nestest.log calls all of the unofficial NOPs "NOP", and ISC "ISB".
+		const char* opName = opInfo.opName;
+		if (std::strcmp(opName, NES_OP_DOP_NAME) == 0 || std::strcmp(opName, NES_OP_TOP_NAME) == 0)
+			opName = NES_OP_NOP_NAME;
+		else if (std::strcmp(opName, NES_OP_ISC_NAME) == 0)
+			opName = "ISB";
+
+		u16 operand = record.opBytes[1];
+		if (record.opSize >= 3)
+			operand |= (record.opBytes[2] << 8);
+		if (opInfo.addrMode == NESCPUOpAddrMode::RELATIVE)
+			operand = record.PC + 2 + static_cast<s8>(record.opBytes[1]);
+
+		os << std::left << std::setfill(' ') << std::setw(31)
+			<< NESCPU::OpAsAsm(opName, opInfo.addrMode, operand)
+			<< std::right << std::setfill('0');
+
+		// Registers, followed by the position of the PPU and the CPU cycle.
+		os << " A:" << std::setw(2) << +record.A
+			<< " X:" << std::setw(2) << +record.X
+			<< " Y:" << std::setw(2) << +record.Y
+			<< " P:" << std::setw(2) << +record.P
+			<< " SP:" << std::setw(2) << +record.SP
+			<< std::dec << std::setfill(' ')
+			<< " PPU:" << std::setw(3) << record.ppuScanline << "," << std::setw(3) << record.ppuCycle
+			<< " CYC:" << record.cpuCycle
+			<< std::hex << std::setfill('0') << '\n';
+	}
+
+	os.flags(flags);
+	os.fill(fill);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cassert>
+#include <ostream>
+#include <vector>
+
+#include "NESTypes.h"
+
+/**
+* A fixed-size binary record of the state of the CPU right before it executes an instruction.
+*/
+struct NESCPUTraceRecord
+{
+	u64 cpuCycle;
+	u16 PC;
+	u16 ppuScanline, ppuCycle;
+
+	// Bytes of the instruction (only the first opSize bytes are valid).
+	u8 opBytes[3];
+	u8 opSize;
+
+	u8 A, X, Y, P, SP;
+};
+
+/**
+* Preallocated ring buffer of the most recent instructions executed by the CPU.
+* Recording only copies a record into the buffer, so it is cheap enough to be left armed. Formatting
+* the records as text is left to ExportNestestLog(), which can be called once something goes wrong.
+*/
+class NESCPUTraceBuffer
+{
+public:
+	/**
+	* Creates a buffer that holds the most recent capacity instructions.
+	*/
+	explicit NESCPUTraceBuffer(std::size_t capacity);
+	~NESCPUTraceBuffer();
+
+	/**
+	* Gets the next record to be filled in, overwriting the oldest record if the buffer is full.
+	*/
+	inline NESCPUTraceRecord& Push()
+	{
+		auto& record = records_[nextIndex_];
+
+		if (++nextIndex_ == records_.size())
+			nextIndex_ = 0;
+		if (size_ < records_.size())
+			++size_;
+
+		return record;
+	}
+
+	/**
+	* Removes all of the records from the buffer.
+	*/
+	void Clear();
+
+	/**
+	* Gets the record at the specified index, where 0 is the oldest record in the buffer.
+	*/
+	inline const NESCPUTraceRecord& GetRecord(std::size_t i) const
+	{
+		assert(i < size_);
+		return records_[(nextIndex_ + records_.size() - size_ + i) % records_.size()];
+	}
+
+	/**
+	* Gets the amount of records currently in the buffer.
+	*/
+	inline std::size_t GetSize() const { return size_; }
+
+	/**
+	* Gets the maximum amount of records that the buffer can hold.
+	*/
+	inline std::size_t GetCapacity() const { return records_.size(); }
+
+	/**
+	* Writes the records in the buffer, from oldest to newest, as text in the layout used by nestest.log.
+	* @NOTE Memory isn't recorded, so the values at effective addresses that nestest.log
+	* shows after the operands (e.g "= 00") are left out.
+	*/
+	void ExportNestestLog(std::ostream& os) const;
+
+private:
+	std::vector<NESCPUTraceRecord> records_;
+	std::size_t nextIndex_, size_;
+};
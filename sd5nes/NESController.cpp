@@ -43,20 +43,21 @@ NESControllerButton NESStandardController::GetButtonFromNumber(unsigned int butt
 }
 
 
+u8 NESStandardController::GetButtonBit(NESControllerButton button)
+{
+	assert(button != NESControllerButton::UNKNOWN);
+
+	// Buttons are declared in the order of their numbers.
+	return (1 << static_cast<unsigned int>(button));
+}
+
+
 NESStandardController::NESStandardController() :
+buttonStates_(0),
 allowUpDownOrLeftRight_(false),
 isStrobeHigh_(false),
 buttonNumber_(0)
 {
-	// Init button state map.
-	buttonStates_.emplace(NESControllerButton::A, false);
-	buttonStates_.emplace(NESControllerButton::B, false);
-	buttonStates_.emplace(NESControllerButton::SELECT, false);
-	buttonStates_.emplace(NESControllerButton::START, false);
-	buttonStates_.emplace(NESControllerButton::UP, false);
-	buttonStates_.emplace(NESControllerButton::DOWN, false);
-	buttonStates_.emplace(NESControllerButton::LEFT, false);
-	buttonStates_.emplace(NESControllerButton::RIGHT, false);
 }
 
 
@@ -67,26 +68,22 @@ NESStandardController::~NESStandardController()
 
 void NESStandardController::ResetButtonStates()
 {
-	for (auto& state : buttonStates_)
-		state.second = false;
+	buttonStates_ = 0;
 }
 
 
 bool NESStandardController::GetButtonState(NESControllerButton button) const
 {
-	const auto it = buttonStates_.find(button);
-	assert(it != buttonStates_.end());
-
-	return it->second;
+	return ((buttonStates_ & GetButtonBit(button)) != 0);
 }
 
 
 void NESStandardController::SetButtonStateInternal(NESControllerButton button, bool isPressed)
 {
-	const auto it = buttonStates_.find(button);
-	assert(it != buttonStates_.end());
-
-	it->second = isPressed;
+	if (isPressed)
+		buttonStates_ |= GetButtonBit(button);
+	else
+		buttonStates_ &= static_cast<u8>(~GetButtonBit(button));
 }
 
 
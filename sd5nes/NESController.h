@@ -1,6 +1,6 @@
 #pragma once
 
-#include <unordered_map>
+#include <atomic>
 
 #include "NESTypes.h"
 #include "NESHelper.h"
@@ -36,6 +36,7 @@ enum class NESControllerButton
 
 /**
 * Represents the standard controller used by the NES.
+* Button states can be set from a different thread than the one emulating the NES.
 */
 class NESStandardController : public INESController
 {
@@ -77,7 +78,8 @@ private:
 	*/
 	static NESControllerButton GetButtonFromNumber(unsigned int buttonNumber);
 
-	std::unordered_map<NESControllerButton, bool, NESHelper::EnumClassHash> buttonStates_;
+	// Bit n is set if the button with number n is pressed.
+	std::atomic<u8> buttonStates_;
 
 	// Whether or not pressing Up+Down / Left+Right simultaneously should be allowed.
 	bool allowUpDownOrLeftRight_;
@@ -85,5 +87,10 @@ private:
 	bool isStrobeHigh_;
 	unsigned int buttonNumber_;
 
+	/**
+	* Gets the bit of a button in the button states.
+	*/
+	static u8 GetButtonBit(NESControllerButton button);
+
 	void SetButtonStateInternal(NESControllerButton button, bool isPressed);
 };
@@ -2,4 +2,7 @@
 
 /* Specifies emulation window default size */
 #define NES_EMU_DEFAULT_WINDOW_WIDTH 256
-#define NES_EMU_DEFAULT_WINDOW_HEIGHT 231
\ No newline at end of file
+#define NES_EMU_DEFAULT_WINDOW_HEIGHT 231
+
+/* Duration of an NTSC NES frame in nanoseconds (~60.0988 FPS). */
+#define NES_EMU_FRAME_DURATION_NS 16639267
\ No newline at end of file
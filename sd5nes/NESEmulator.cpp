@@ -1,27 +1,36 @@
 #include "NESEmulator.h"
 
+#include <chrono>
+#include <cstring>
 #include <fstream>
-#include <iostream> // @TODO DEBUG!
-
-#include <SFML/Graphics/Sprite.hpp>
-#include <SFML/Graphics/Texture.hpp>
 
 #include <SFML/Graphics/Text.hpp> //@TODO DEBUG!
 
+#include "NESEmulationConstants.h"
+
 
 NESEmulator::NESEmulator(sf::RenderTarget& target, const sf::Font& debugFont) :
 target_(target),
-ppu_(debug_), // @TODO DEBUG!
-debugFont_(debugFont)
+debugFont_(debugFont),
+isLastFrameValid_(false),
+isFrameTextureStale_(false),
+frameSkip_(1),
+frameSkipCounter_(0),
+shouldEmulationThreadRun_(false),
+testMonitor_(nullptr)
 {
 	// Init controller ports
 	for (auto& port : controllers_)
 		port = nullptr;
+
+	frameTexture_.create(NES_PPU_FRAME_WIDTH, NES_PPU_FRAME_HEIGHT);
+	frameSprite_.setTexture(frameTexture_);
 }
 
 
 NESEmulator::~NESEmulator()
 {
+	StopEmulationThread();
 }
 
 
@@ -77,15 +86,55 @@ bool NESEmulator::RemoveController(NESControllerPort port)
 }
 
 
+void NESEmulator::SetTestStatusMonitor(NESTestStatusMonitor* testMonitor)
+{
+	testMonitor_ = testMonitor;
+
+	if (cpuComm_)
+		cpuComm_->SetTestStatusMonitor(testMonitor_);
+}
+
+
+void NESEmulator::SetCPUTraceBuffer(NESCPUTraceBuffer* trace)
+{
+	cpu_.SetTraceBuffer(trace);
+}
+
+
+void NESEmulator::SetFrameSkip(unsigned int frameSkip)
+{
+	assert(frameSkip > 0);
+
+	frameSkip_ = frameSkip;
+	frameSkipCounter_ = 0;
+}
+
+
+void NESEmulator::SetVideoFilter(std::unique_ptr<NESVideoFilter> videoFilter)
+{
+	videoFilter_ = std::move(videoFilter);
+
+	if (videoFilter_)
+		frameTexture_.create(videoFilter_->GetOutputWidth(), videoFilter_->GetOutputHeight());
+	else
+		frameTexture_.create(NES_PPU_FRAME_WIDTH, NES_PPU_FRAME_HEIGHT);
+
+	frameSprite_.setTexture(frameTexture_, true);
+	isFrameTextureStale_ = true;
+}
+
+
 void NESEmulator::LoadROM(const std::string& fileName)
 {
 	// @TODO: debugdebugdebug
 	cart_.LoadROM(fileName);
 	cartState_ = cart_.GetNewGamePakPowerState();
 
-	cpuComm_ = std::make_unique<NESCPUEmuComm>(cpuRam_, ppu_, cartState_->GetMMC(), controllers_);
+	cpuComm_ = std::make_unique<NESCPUEmuComm>(cpuRam_, cpu_, ppu_, cartState_->GetMMC(), controllers_);
 	ppuComm_ = std::make_unique<NESPPUEmuComm>(ppuMem_, cpu_, cartState_->GetMMC(), cartState_->GetNameTableMirroringRef());
 
+	cpuComm_->SetTestStatusMonitor(testMonitor_);
+
 	cpu_.Initialize(*cpuComm_);
 	ppu_.Initialize(*ppuComm_);
 
@@ -96,31 +145,106 @@ void NESEmulator::LoadROM(const std::string& fileName)
 
 void NESEmulator::Frame()
 {
-	// @TODO So much debug!!1
-	sf::Sprite spr;
-	sf::Texture tex;
+	assert(!IsEmulationThreadRunning());
+
+	EmulateFrame();
+	DrawLatestFrame();
+}
+
+
+void NESEmulator::StartEmulationThread()
+{
+	assert(!IsEmulationThreadRunning());
+
+	shouldEmulationThreadRun_ = true;
+	emulationThread_ = std::thread(&NESEmulator::EmulationThreadMain, this);
+}
+
+
+void NESEmulator::StopEmulationThread()
+{
+	if (!IsEmulationThreadRunning())
+		return;
+
+	shouldEmulationThreadRun_ = false;
+	emulationThread_.join();
+}
+
+
+void NESEmulator::DrawLatestFrame()
+{
+	// Skipped and unchanged frames aren't published, so the texture is only updated when there is a new frame.
+	if (frameBuffers_.Acquire() || isFrameTextureStale_)
+	{
+		const auto& frame = frameBuffers_.GetFrontBuffer();
+
+		if (videoFilter_)
+			frameTexture_.update(reinterpret_cast<const sf::Uint8*>(videoFilter_->Apply(frame).data()));
+		else
+			frameTexture_.update(frame.data());
+
+		isFrameTextureStale_ = false;
+	}
+
+	target_.draw(frameSprite_);
+}
+
+
+void NESEmulator::EmulationThreadMain()
+{
+	const std::chrono::nanoseconds frameDuration(NES_EMU_FRAME_DURATION_NS);
+	auto nextFrameTime = std::chrono::steady_clock::now();
+
+	while (shouldEmulationThreadRun_)
+	{
+		EmulateFrame();
+
+		// Run as fast as possible when skipping frames (fast-forward).
+		if (frameSkip_ > 1)
+			continue;
 
-	// @TODO: DEBUG!!
-	debug_.create(341, 262, ppu_.GetBackdropColor().ToSFColor());
+		// If we've fallen behind, don't try to catch up by running frames back-to-back.
+		nextFrameTime += frameDuration;
+		const auto now = std::chrono::steady_clock::now();
 
+		if (nextFrameTime < now)
+			nextFrameTime = now;
+		else
+			std::this_thread::sleep_until(nextFrameTime);
+	}
+}
+
+
+void NESEmulator::EmulateFrame()
+{
 	// Keep ticking until a frame is fully rendered by the PPU.
 	const auto elapsedFrames = ppu_.GetElapsedFramesCount();
 
-    // @TODO: Debug information to console
-    std::cout << "F " << elapsedFrames << ", C " << cpu_.GetElapsedCycles() << std::endl;
-    std::cout << " CPU: " << cpu_.GetRegisters().ToString() << std::endl;
-    std::cout << " PPU: " << ppu_.GetRegisters().ToString() << std::endl;
+	// The PPU has already started this frame, so it can only be told whether to output the next one.
+	const bool isOutputFrame = ppu_.IsFrameOutputEnabled();
+	frameSkipCounter_ = (frameSkipCounter_ + 1) % frameSkip_;
+	ppu_.SetNextFrameOutputEnabled(frameSkipCounter_ == 0);
 
 	while (elapsedFrames == ppu_.GetElapsedFramesCount())
 	{
-		cpu_.Tick();
-
-		ppu_.Tick();
-		ppu_.Tick();
-		ppu_.Tick();
+		// Run the CPU up until the first cycle where it could see the result of the PPU's
+		// next sync event (V-BLANK NMI or end of frame), then have the PPU catch up with it.
+		// The CPU will also sync the PPU itself whenever it accesses the PPU.
+		cpu_.RunUntil((ppu_.GetNextSyncCycle() / NES_PPU_CYCLES_PER_CPU_CYCLE) + 1);
+		ppu_.CatchUp(cpu_.GetElapsedCycles() * NES_PPU_CYCLES_PER_CPU_CYCLE);
 	}
 
-	tex.loadFromImage(debug_);
-	spr.setTexture(tex);
-	target_.draw(spr);
+	if (!isOutputFrame)
+		return;
+
+	// Unchanged frames are skipped, as the last published frame is already in the texture (or on its way to it).
+	const auto& frame = ppu_.GetFrontBuffer();
+	if (isLastFrameValid_ && std::memcmp(frame.data(), lastFrame_.data(), sizeof(frame)) == 0)
+		return;
+
+	NESPPU::ConvertFrameToRGBA(frame, frameBuffers_.GetBackBuffer());
+	frameBuffers_.Publish();
+
+	lastFrame_ = frame;
+	isLastFrameValid_ = true;
 }
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <thread>
 
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Texture.hpp>
 
 #include "NESCPU.h"
 #include "NESCPUEmuComm.h"
@@ -11,6 +15,8 @@
 #include "NESPPUEmuComm.h"
 #include "NESGamePak.h"
 #include "NESController.h"
+#include "NESTripleBuffer.h"
+#include "NESVideoFilter.h"
 
 /**
 * Enum containing the different numbers of the controller ports on the NES.
@@ -42,24 +48,96 @@ public:
 	*/
 	bool RemoveController(NESControllerPort port);
 
+	/**
+	* Sets the monitor used to watch the status of test ROMs, or nullptr to stop monitoring.
+	* The monitor isn't owned by the emulator.
+	*/
+	void SetTestStatusMonitor(NESTestStatusMonitor* testMonitor);
+
+	/**
+	* Sets the buffer that the CPU records every instruction it executes to, or nullptr to stop tracing.
+	* The buffer isn't owned by the emulator.
+	*/
+	void SetCPUTraceBuffer(NESCPUTraceBuffer* trace);
+
+	/**
+	* Sets the emulator to only output 1 of every frameSkip frames (1 outputs every frame).
+	* Skipped frames are still fully emulated (including everything that affects PPUSTATUS),
+	* but the PPU doesn't draw them and the last output frame is drawn in their place.
+	*/
+	void SetFrameSkip(unsigned int frameSkip);
+
+	/**
+	* Sets the filter that output frames are scaled and filtered with before they're drawn, or nullptr to draw them unfiltered.
+	* Frames are filtered by the thread that draws them, so the emulation thread isn't slowed down by it.
+	* Should only be called from the thread that draws the frames.
+	*/
+	void SetVideoFilter(std::unique_ptr<NESVideoFilter> videoFilter);
+
 	/**
 	* Loads a ROM.
 	*/
 	void LoadROM(const std::string& fileName);
 
 	/**
-	* Runs one frame of emulation.
+	* Runs one frame of emulation and draws the newest output frame.
+	* Shouldn't be called while the emulation thread is running.
 	*/
 	void Frame();
 
+	/**
+	* Starts running the emulation on its own thread, paced to the NES frame rate
+	* (or as fast as possible if frames are being skipped).
+	* The ROM, controllers, monitors and frame skip shouldn't be changed while it is running.
+	*/
+	void StartEmulationThread();
+
+	/**
+	* Stops the emulation thread after it finishes its current frame, waiting for it to exit.
+	* Does nothing if the thread isn't running.
+	*/
+	void StopEmulationThread();
+
+	/**
+	* Whether or not the emulation thread is running.
+	*/
+	inline bool IsEmulationThreadRunning() const { return emulationThread_.joinable(); }
+
+	/**
+	* Draws the newest frame output by the emulation.
+	* Safe to call from the render thread while the emulation thread is running.
+	*/
+	void DrawLatestFrame();
+
 private:
 	sf::RenderTarget& target_;
 	const sf::Font& debugFont_;
 	
-	// @TODO Debug!! everyWHERE!!
-	sf::Image debug_;
+	// Output frames converted to RGBA, handed off from the emulation to the render thread.
+	NESTripleBuffer<NESPPUFrameRGBA> frameBuffers_;
+
+	// Copy of the last published frame. Output frames with the same pixels aren't converted or published,
+	// so the render thread doesn't upload them again.
+	NESPPUFrameBuffer lastFrame_;
+	bool isLastFrameValid_;
+
+	// The texture & sprite used to draw the last acquired frame (after it was filtered, if there is a filter).
+	// The texture is stale if it needs to be updated from the last acquired frame again.
+	sf::Texture frameTexture_;
+	sf::Sprite frameSprite_;
+	bool isFrameTextureStale_;
+
+	std::unique_ptr<NESVideoFilter> videoFilter_;
+
+	// Only 1 of every frameSkip_ frames is output. frameSkipCounter_ is 0 on the frames that are.
+	unsigned int frameSkip_, frameSkipCounter_;
+
+	// The emulation thread runs until shouldEmulationThreadRun_ is cleared.
+	std::thread emulationThread_;
+	std::atomic<bool> shouldEmulationThreadRun_;
 
 	NESControllerPorts controllers_;
+	NESTestStatusMonitor* testMonitor_;
 
 	NESGamePak cart_;
 	std::unique_ptr<NESGamePakPowerState> cartState_;
@@ -71,4 +149,14 @@ private:
 	NESPPUMemory ppuMem_;
 	std::unique_ptr<NESPPUEmuComm> ppuComm_;
 	NESPPU ppu_;
+
+	/**
+	* Runs one frame of emulation, publishing it to the frame buffers if it is output.
+	*/
+	void EmulateFrame();
+
+	/**
+	* Entry point of the emulation thread.
+	*/
+	void EmulationThreadMain();
 };
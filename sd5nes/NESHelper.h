@@ -3,6 +3,18 @@
 #include <string>
 #include <cassert>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+* Defined if SSE2 intrinsics (<emmintrin.h>) can be used.
+* SSE2 is always available when targeting x86-64.
+*/
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NES_HAS_SSE2
+#endif
+
 #include "NESTypes.h"
 #include "NESMemory.h"
 
@@ -127,6 +139,35 @@ namespace NESHelper
 		return val;
 	}
 
+	/**
+	* Gets the position of the lowest set bit of a 64-bit value.
+	* val cannot be 0.
+	*/
+	inline u8 GetLowestSetBitPos(u64 val)
+	{
+		assert(val != 0);
+
+#if defined(__GNUC__)
+		return static_cast<u8>(__builtin_ctzll(val));
+#elif defined(_MSC_VER)
+		// Scan each half separately, as _BitScanForward64 isn't available on x86.
+		unsigned long pos;
+		if (_BitScanForward(&pos, static_cast<unsigned long>(val)))
+			return static_cast<u8>(pos);
+
+		_BitScanForward(&pos, static_cast<unsigned long>(val >> 32));
+		return static_cast<u8>(pos + 32);
+#else
+		u8 pos = 0;
+		while ((val & 1) == 0)
+		{
+			val >>= 1;
+			++pos;
+		}
+		return pos;
+#endif
+	}
+
 	/**
 	* Checks whether or not addr1 and addr2 are in the same page of memory.
 	*/
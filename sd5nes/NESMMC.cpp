@@ -6,7 +6,8 @@ NESMMCNROM::NESMMCNROM(NESMemSRAMBank& sram,
 	const NESMemPRGROMBank& prg1, 
 	const NESMemPRGROMBank* prg2) :
 sram_(sram),
-chr_(chr)
+chr_(chr),
+chrTileCache_(chr)
 {
 	prg_[0] = &prg1;
 	prg_[1] = (prg2 != nullptr ? prg2 : &prg1);
@@ -18,10 +19,23 @@ NESMMCNROM::~NESMMCNROM()
 }
 
 
+void NESMMCNROM::MapCPUPages(NESMemoryPageTable& pageTable)
+{
+	pageTable.MapReadWrite(0x6000, 0x2000, sram_.GetData(), sram_.GetSize());
+
+	// Writes to PRG-ROM are ignored by Write8().
+	pageTable.MapReadOnly(0x8000, 0x4000, prg_[0]->GetData(), prg_[0]->GetSize());
+	pageTable.MapReadOnly(0xC000, 0x4000, prg_[1]->GetData(), prg_[1]->GetSize());
+}
+
+
 void NESMMCNROM::Write8(u16 addr, u8 val)
 {
 	if (addr < 0x2000) // CHR-ROM / CHR-RAM
+	{
 		chr_.Write8(addr, val);
+		chrTileCache_.Invalidate(addr);
+	}
 	else if (addr >= 0x6000 && addr < 0x8000) // SRAM
 		sram_.Write8(addr - 0x6000, val);
 }
@@ -61,6 +75,10 @@ prgBankNumber_(0)
 	// and that we do not have more banks than the mapper can use.
 	assert(sram_.size() != 0 && chr_.size() != 0 && prg_.size() != 0);
 	assert(sram_.size() <= 4 && chr_.size() <= 16 && prg_.size() <= 32);
+
+	chrTileCaches_.reserve(chr_.size());
+	for (const auto& chrBank : chr_)
+		chrTileCaches_.emplace_back(chrBank);
 }
 
 
@@ -69,6 +87,28 @@ NESMMC1::~NESMMC1()
 }
 
 
+const NESCHRDecodedTile& NESMMC1::GetDecodedCHRTile(u16 addr)
+{
+	u16 bankAddr;
+	const auto bankIdx = GetCHRBankAddress(addr, bankAddr);
+
+	return chrTileCaches_[bankIdx].GetTile(bankAddr);
+}
+
+
+void NESMMC1::MapCPUPages(NESMemoryPageTable& pageTable)
+{
+	pageTable.MapReadWrite(0x6000, 0x2000, sram_[0].GetData(), sram_[0].GetSize());
+
+	// PRG-ROM is mapped for reading only so that writes still reach the MMC1 registers.
+	for (std::size_t i = 0; i < prgBankIndices_.size(); ++i)
+	{
+		const auto& prgBank = prg_[prgBankIndices_[i]];
+		pageTable.MapReadOnly(0x8000 + (i * 0x4000), 0x4000, prgBank.GetData(), prgBank.GetSize());
+	}
+}
+
+
 void NESMMC1::UpdateBankMappings()
 {
 	switch (prgBankMode_)
@@ -105,6 +145,8 @@ void NESMMC1::UpdateBankMappings()
 		chrBankIndices_[1] = (chrBank1Number_ & 0x1F) % (chr_.size() * 2);
 		break;
 	}
+
+	UpdateCPUPageTable();
 }
 
 
@@ -180,13 +222,11 @@ void NESMMC1::Write8(u16 addr, u8 val)
 {
 	if (addr < 0x2000) // CHR-ROM / CHR-RAM
 	{
-		const auto addrBankNum = addr / 0x1000;
-		const auto chrIdx = chrBankIndices_[addrBankNum];
+		u16 bankAddr;
+		const auto bankIdx = GetCHRBankAddress(addr, bankAddr);
 
-		if (chrBankMode_ == 0) // 8 KB Banks
-			chr_[chrIdx / 2].Write8(addr, val);
-		else // 4+4 KB Banks - We consider upper or lower part of the 8KB NESMemCHRBank.
-			chr_[chrIdx / 2].Write8((addr & 0xFFF) | ((chrIdx % 2) * 0x1000), val);
+		chr_[bankIdx].Write8(bankAddr, val);
+		chrTileCaches_[bankIdx].Invalidate(bankAddr);
 	}
 	else if (addr >= 0x6000 && addr < 0x8000) // SRAM @TODO
 		sram_[0].Write8(addr - 0x6000, val);
@@ -199,13 +239,10 @@ u8 NESMMC1::Read8(u16 addr) const
 {
 	if (addr < 0x2000) // CHR-ROM / CHR-RAM
 	{
-		const auto addrBankNum = addr / 0x1000;
-		const auto chrIdx = chrBankIndices_[addrBankNum];
+		u16 bankAddr;
+		const auto bankIdx = GetCHRBankAddress(addr, bankAddr);
 
-		if (chrBankMode_ == 0) // 8 KB Banks
-			return chr_[chrIdx / 2].Read8(addr);
-		else // 4+4 KB Banks - We consider upper or lower part of the 8KB NESMemCHRBank.
-			return chr_[chrIdx / 2].Read8((addr & 0xFFF) | ((chrIdx % 2) * 0x1000));
+		return chr_[bankIdx].Read8(bankAddr);
 	}
 	else if (addr >= 0x6000 && addr < 0x8000) // SRAM @TODO
 		return sram_[0].Read8(addr - 0x6000);
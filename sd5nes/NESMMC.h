@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "NESPPU.h"
+#include "NESCHRTileCache.h"
 
 /**
 * The type of MMC.
@@ -21,10 +22,48 @@ enum class NESMMCType
 class INESMMC : public INESMemoryInterface
 {
 public:
-	INESMMC() { }
+	INESMMC() : cpuPageTable_(nullptr) { }
 	virtual ~INESMMC() { }
 
 	virtual NESMMCType GetType() const = 0;
+
+	/**
+	* Gets the index of the PRG-ROM bank that is currently mapped at addr ($8000 - $FFFF).
+	*/
+	virtual std::size_t GetPRGBankIndex(u16 addr) const = 0;
+
+	/**
+	* Gets the decoded tile of the CHR bank that is currently mapped at addr ($0000 - $1FFF).
+	*/
+	virtual const NESCHRDecodedTile& GetDecodedCHRTile(u16 addr) = 0;
+
+	/**
+	* Sets the CPU page table that the MMC maps its SRAM and PRG-ROM banks into.
+	* The MMC keeps the table up to date whenever it switches banks.
+	*/
+	inline void AttachCPUPageTable(NESMemoryPageTable* pageTable)
+	{
+		cpuPageTable_ = pageTable;
+		UpdateCPUPageTable();
+	}
+
+protected:
+	/**
+	* Maps the MMC's SRAM and currently selected PRG-ROM banks ($6000 - $FFFF) into the CPU page table.
+	*/
+	virtual void MapCPUPages(NESMemoryPageTable& pageTable) = 0;
+
+	/**
+	* Updates the attached CPU page table (if any). Should be called after switching banks.
+	*/
+	inline void UpdateCPUPageTable()
+	{
+		if (cpuPageTable_ != nullptr)
+			MapCPUPages(*cpuPageTable_);
+	}
+
+private:
+	NESMemoryPageTable* cpuPageTable_;
 };
 
 /**
@@ -41,12 +80,21 @@ public:
 
 	inline NESMMCType GetType() const override { return NESMMCType::NROM; }
 
+	// Bank 1 is a mirror of bank 0 if there is no second bank.
+	inline std::size_t GetPRGBankIndex(u16 addr) const override { return (addr >= 0xC000 && prg_[1] != prg_[0] ? 1 : 0); }
+
+	inline const NESCHRDecodedTile& GetDecodedCHRTile(u16 addr) override { return chrTileCache_.GetTile(addr); }
+
 	void Write8(u16 addr, u8 val) override;
 	u8 Read8(u16 addr) const override;
 
+protected:
+	void MapCPUPages(NESMemoryPageTable& pageTable) override;
+
 private:
 	NESMemSRAMBank& sram_;
 	NESMemCHRBank& chr_;
+	NESCHRTileCache chrTileCache_;
 	std::array<const NESMemPRGROMBank*, 2> prg_;
 };
 
@@ -64,12 +112,20 @@ public:
 
 	inline NESMMCType GetType() const override { return NESMMCType::MMC1; }
 
+	inline std::size_t GetPRGBankIndex(u16 addr) const override { return prgBankIndices_[(addr & 0x7FFF) / 0x4000]; }
+
+	const NESCHRDecodedTile& GetDecodedCHRTile(u16 addr) override;
+
 	void Write8(u16 addr, u8 val) override;
 	u8 Read8(u16 addr) const override;
 
+protected:
+	void MapCPUPages(NESMemoryPageTable& pageTable) override;
+
 private:
 	std::vector<NESMemSRAMBank> sram_;
 	std::vector<NESMemCHRBank> chr_;
+	std::vector<NESCHRTileCache> chrTileCaches_;
 	const std::vector<NESMemPRGROMBank> prg_;
 	NESNameTableMirroringType& ntMirror_;
 
@@ -85,6 +141,21 @@ private:
 
 	void UpdateBankMappings();
 
+	/**
+	* Gets the index of the NESMemCHRBank mapped at addr ($0000 - $1FFF), and the address inside of it.
+	*/
+	inline std::size_t GetCHRBankAddress(u16 addr, u16& bankAddr) const
+	{
+		const auto chrIdx = chrBankIndices_[addr / 0x1000];
+
+		if (chrBankMode_ == 0) // 8 KB Banks
+			bankAddr = addr;
+		else // 4+4 KB Banks - We consider upper or lower part of the 8KB NESMemCHRBank.
+			bankAddr = (addr & 0xFFF) | ((chrIdx % 2) * 0x1000);
+
+		return chrIdx / 2;
+	}
+
 	void WriteControlRegister(u8 val);
 	void HandleRegisterWrite(u16 addr, u8 val);
 };
\ No newline at end of file
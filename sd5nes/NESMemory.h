@@ -91,10 +91,109 @@ public:
 	*/
 	inline u32 GetSize() const { return data_.size(); }
 
+	/**
+	* Gets a pointer to the allocated memory so that it can be accessed directly.
+	*/
+	inline u8* GetData() { return data_.data(); }
+	inline const u8* GetData() const { return data_.data(); }
+
 private:
 	std::array<u8, size> data_;
 };
 
 typedef NESMemory<0x4000> NESMemPRGROMBank;
 typedef NESMemory<0x2000> NESMemCHRBank;
-typedef NESMemory<0x2000> NESMemSRAMBank;
\ No newline at end of file
+typedef NESMemory<0x2000> NESMemSRAMBank;
+
+/**
+* Maps each 256 byte page of a 16-bit address space directly to host memory.
+* Pages that aren't mapped (nullptr) need to be handled by the owner of the table instead (I/O registers etc.)
+*/
+class NESMemoryPageTable
+{
+public:
+	NESMemoryPageTable()
+	{
+		writeWatchedPages_.fill(false);
+		Unmap(0, 0x10000);
+	}
+	~NESMemoryPageTable() { }
+
+	/**
+	* Maps size bytes starting at startAddr to data for reading and writing.
+	* data is mirrored every dataSize bytes. startAddr, size and dataSize should be multiples of the page size.
+	*/
+	void MapReadWrite(u16 startAddr, u32 size, u8* data, u32 dataSize)
+	{
+		MapReadOnly(startAddr, size, data, dataSize);
+
+		for (u32 i = 0; i < size; i += 0x100)
+		{
+			if (!writeWatchedPages_[(startAddr + i) >> 8])
+				writePages_[(startAddr + i) >> 8] = data + (i % dataSize);
+		}
+	}
+
+	/**
+	* Maps size bytes starting at startAddr to data for reading only.
+	* Writes to these pages need to be handled by the owner of the table.
+	* data is mirrored every dataSize bytes. startAddr, size and dataSize should be multiples of the page size.
+	*/
+	void MapReadOnly(u16 startAddr, u32 size, const u8* data, u32 dataSize)
+	{
+		assert((startAddr & 0xFF) == 0 && (size & 0xFF) == 0 && (dataSize & 0xFF) == 0 && dataSize != 0);
+		assert(startAddr + size <= 0x10000);
+
+		for (u32 i = 0; i < size; i += 0x100)
+		{
+			readPages_[(startAddr + i) >> 8] = data + (i % dataSize);
+			writePages_[(startAddr + i) >> 8] = nullptr;
+		}
+	}
+
+	/**
+	* Unmaps size bytes starting at startAddr.
+	*/
+	void Unmap(u16 startAddr, u32 size)
+	{
+		assert((startAddr & 0xFF) == 0 && (size & 0xFF) == 0);
+		assert(startAddr + size <= 0x10000);
+
+		for (u32 i = 0; i < size; i += 0x100)
+		{
+			readPages_[(startAddr + i) >> 8] = nullptr;
+			writePages_[(startAddr + i) >> 8] = nullptr;
+		}
+	}
+
+	/**
+	* Watches writes to size bytes starting at startAddr. These pages will never be mapped for writing,
+	* so that the owner of the table handles every write to them.
+	*/
+	void WatchWrites(u16 startAddr, u32 size)
+	{
+		assert((startAddr & 0xFF) == 0 && (size & 0xFF) == 0);
+		assert(startAddr + size <= 0x10000);
+
+		for (u32 i = 0; i < size; i += 0x100)
+		{
+			writeWatchedPages_[(startAddr + i) >> 8] = true;
+			writePages_[(startAddr + i) >> 8] = nullptr;
+		}
+	}
+
+	/**
+	* Gets the host memory of the page containing addr for reading, or nullptr if it isn't mapped.
+	*/
+	inline const u8* GetReadPage(u16 addr) const { return readPages_[addr >> 8]; }
+
+	/**
+	* Gets the host memory of the page containing addr for writing, or nullptr if it isn't mapped.
+	*/
+	inline u8* GetWritePage(u16 addr) const { return writePages_[addr >> 8]; }
+
+private:
+	std::array<const u8*, 0x100> readPages_;
+	std::array<u8*, 0x100> writePages_;
+	std::array<bool, 0x100> writeWatchedPages_;
+};
@@ -1,13 +1,25 @@
 #include "NESPPU.h"
+#include "NESPPUCompositor.h"
+#include "NESPPURenderWorker.h"
 
+#include <algorithm>
 
-NESPPU::NESPPU(sf::Image& debug) :
+
+NESPPU::NESPPU() :
 comm_(nullptr),
 currentCycle_(0),
 elapsedCycles_(0),
 elapsedFrames_(0),
-debug_(debug) // @TODO Debug!!
+backBufferIndex_(0),
+isFrameOutputEnabled_(true),
+isNextFrameOutputEnabled_(true),
+isEventPredictionValid_(false),
+isPalettePixelsDirty_(true)
 {
+	for (auto& frameBuffer : frameBuffers_)
+		frameBuffer.fill(0);
+
+	renderWorker_ = std::make_unique<NESPPURenderWorker>();
 }
 
 
@@ -43,8 +55,12 @@ void NESPPU::HandlePPUDATAAccess()
 void NESPPU::WriteRegister(NESPPURegisterType reg, u8 val)
 {
 	// Update the internal data bus value to the value being written.
+	// The value decays after the tick that is NES_PPU_DATA_BUS_DECAY_CYCLES after this one.
 	latches_.internalDataBusVal = val;
-	latches_.cyclesLeftUntilBusDecay = NES_PPU_DATA_BUS_DECAY_CYCLES;
+	latches_.busDecayCycle = elapsedCycles_ + NES_PPU_DATA_BUS_DECAY_CYCLES + 1;
+
+	// Any write can change the rendering state used to predict events.
+	InvalidateEventPrediction();
 
 	switch (reg)
 	{
@@ -53,7 +69,7 @@ void NESPPU::WriteRegister(NESPPURegisterType reg, u8 val)
 		return;
 
 		// Check if we should ignore writes to some registers.
-		if (reg_.writeIgnoreCyclesLeft == 0)
+		if (elapsedCycles_ >= reg_.writeIgnoreUntilCycle)
 		{
 		case NESPPURegisterType::PPUCTRL:
 			reg_.PPUCTRL = val;
@@ -69,6 +85,10 @@ void NESPPU::WriteRegister(NESPPURegisterType reg, u8 val)
 			break;
 
 		case NESPPURegisterType::PPUMASK:
+			// Changing the greyscale or emphasis bits changes the pixels of every palette entry.
+			if (((reg_.PPUMASK ^ val) & 0xE1) != 0)
+				isPalettePixelsDirty_ = true;
+
 			reg_.PPUMASK = val;
 			break;
 
@@ -113,6 +133,10 @@ void NESPPU::WriteRegister(NESPPURegisterType reg, u8 val)
 
 	case NESPPURegisterType::PPUDATA:
 		comm_->Write8(vScroll_, val);
+
+		if ((vScroll_ & 0x3FFF) >= 0x3F00)
+			isPalettePixelsDirty_ = true;
+
 		HandlePPUDATAAccess();
 		break;
 
@@ -121,14 +145,14 @@ void NESPPU::WriteRegister(NESPPURegisterType reg, u8 val)
 		break;
 
 	case NESPPURegisterType::OAMDATA:
-		primaryOam_.Write8(reg_.OAMADDR, val);
+		WritePrimaryOAM(reg_.OAMADDR, val);
 		++reg_.OAMADDR;
 		break;
 
 	case NESPPURegisterType::OAMDMA:
 		const auto oamDmaData = comm_->OAMDMARead(val);
 		for (u16 i = 0; i < 0x100; ++i)
-			primaryOam_.Write8((i + reg_.OAMADDR) & 0xFF, oamDmaData[i]);
+			WritePrimaryOAM((i + reg_.OAMADDR) & 0xFF, oamDmaData[i]);
 		break;
 	}
 }
@@ -180,7 +204,7 @@ u8 NESPPU::ReadRegister(NESPPURegisterType reg)
 		break;
 
 	default:
-		returnVal = latches_.internalDataBusVal;
+		returnVal = GetInternalDataBusValue();
 		break;
 	}
 
@@ -193,6 +217,9 @@ void NESPPU::Power()
 {
 	assert(comm_ != nullptr);
 
+	// The scanlines of the current frame can be rendered again, so their records must not be in use.
+	renderWorker_->Finish();
+
 	elapsedFrames_ = elapsedCycles_ = 0;
 
 	isEvenFrame_ = true;
@@ -203,13 +230,17 @@ void NESPPU::Power()
 
 	ppuStatusReadThisTick_ = isNmiPulled_ = false;
 	tScroll_ = vScroll_ = xScroll_ = activeSpriteCount_ = 0;
+	spriteLine_.fill(0);
 
 	ppuDataBuffered_ = 0;
 
 	latches_.internalDataBusVal = 0;
+	latches_.busDecayCycle = 0;
 	latches_.isAddressLatchOn = false;
 
 	reg_.PPUCTRL = reg_.PPUMASK = reg_.OAMADDR = 0;
+	isPalettePixelsDirty_ = true;
+	isEventPredictionValid_ = false;
 
 	// Set up PPUSTATUS Power state - depends on a few random variables
 	// O and V are often set in PPUSTATUS
@@ -220,6 +251,8 @@ void NESPPU::Power()
 	NESHelper::EditRefBit(reg_.PPUSTATUS, NES_PPU_REG_PPUSTATUS_O_BIT, 
 		NESHelper::GetRandomBool(NES_PPU_POWER_REG_PPUSTATUS_O_SET_CHANCE));
 	
+	RebuildOAMScanlineMasks();
+
 	// @TODO: Init NT RAM to mostly $FF and CHR RAM to unspec pattern and
 	// OAM to pattern
 }
@@ -229,6 +262,12 @@ void NESPPU::Reset()
 {
 	assert(comm_ != nullptr);
 
+	// The value in the internal data bus survives the reset, so keep the same amount of cycles left until it decays.
+	latches_.busDecayCycle -= std::min(latches_.busDecayCycle, elapsedCycles_);
+
+	// The scanlines of the current frame can be rendered again, so their records must not be in use.
+	renderWorker_->Finish();
+
 	elapsedFrames_ = elapsedCycles_ = 0;
 
 	isEvenFrame_ = true;
@@ -238,15 +277,18 @@ void NESPPU::Reset()
 
 	ppuStatusReadThisTick_ = isNmiPulled_ = false;
 	tScroll_ = vScroll_ = xScroll_ = activeSpriteCount_ = 0;
+	spriteLine_.fill(0);
 
 	ppuDataBuffered_ = 0;
 
 	latches_.isAddressLatchOn = false;
 
 	reg_.PPUCTRL = reg_.PPUMASK = 0;
+	isPalettePixelsDirty_ = true;
+	isEventPredictionValid_ = false;
 	reg_.PPUSTATUS &= 0x80; // Only retain bit 7. (PPUSTATUS V)
 
-	reg_.writeIgnoreCyclesLeft = NES_PPU_RESET_REG_IGNORE_WRITE_FOR_CPU_CYC;
+	reg_.writeIgnoreUntilCycle = NES_PPU_RESET_REG_IGNORE_WRITE_FOR_CPU_CYC;
 
 	// @TODO: Init OAM to pattern
 }
@@ -316,47 +358,37 @@ void NESPPU::IncrementScrollY()
 
 void NESPPU::TickFetchTileData()
 {
-	// Only evaluate tile data on visible scanlines.
-	if (currentScanline_ > 239 || !IsRenderingEnabled())
+	// Only evaluate tile data on visible scanlines and the pre-render scanline,
+	// which fetches the first two tiles of scanline 0.
+	if ((currentScanline_ > 239 && currentScanline_ != 261) || !IsRenderingEnabled())
 		return;
 
 	switch (currentCycle_ % 8)
 	{
 	case 0:
-		// Store buffering tile as the active background tile.
-		activeTiles_[1] = activeTiles_[0];
-		activeTiles_[0] = bufferingTile_;
-		bufferingTile_ = NESPPUBGTileData();
+		// Load the fetched tile into the shift registers.
+		bgShifters_.Reload(bgFetchLatches_);
+		bgFetchLatches_ = NESPPUBGFetchLatches();
 		break;
 
 	case 1:
 		// Fetch the Name table Byte.
-		bufferingTile_.ntByte = comm_->Read8(0x2000 | (vScroll_ & 0xFFF));
+		bgFetchLatches_.ntByte = comm_->Read8(0x2000 | (vScroll_ & 0xFFF));
 		break;
 
 	case 3:
 		// Fetch the Attribute table Byte.
-		bufferingTile_.atByte = comm_->Read8(0x23C0 | (vScroll_ & 0xC00) | ((vScroll_ >> 4) & 0x38) | ((vScroll_ >> 2) & 7));
+		bgFetchLatches_.attrib = FetchBackgroundAttribute();
 		break;
 
 	case 5:
 		// Fetch the Tile Bitmap Low Byte from Pattern table.
-		bufferingTile_.tileBitmapLo = FetchTileBitmapLine(
-			GetBackgroundTileAddress(bufferingTile_.ntByte),
-			(vScroll_ >> 12) & 7,
-			false,
-			false
-		);
+		bgFetchLatches_.bitmapLo = comm_->Read8(GetBackgroundTileAddress(bgFetchLatches_.ntByte) + ((vScroll_ >> 12) & 7));
 		break;
 
 	case 7:
 		// Fetch the Tile Bitmap High Byte from Pattern table.
-		bufferingTile_.tileBitmapHi = FetchTileBitmapLine(
-			GetBackgroundTileAddress(bufferingTile_.ntByte) + 8,
-			(vScroll_ >> 12) & 7,
-			false,
-			false
-		);
+		bgFetchLatches_.bitmapHi = comm_->Read8(GetBackgroundTileAddress(bgFetchLatches_.ntByte) + 8 + ((vScroll_ >> 12) & 7));
 		break;
 	}
 }
@@ -377,127 +409,152 @@ void NESPPU::TickEvaluateSprites()
 		secondaryOam_.Write8((currentCycle_ - 1) / 2, 0xFF);
 	}
 	else if (currentCycle_ == 256) // @TODO: Cycle accuracy? CPU isn't truly cycle accurate anyway... (and frankly I just don't care anymore)
+		EvaluateSprites();
+	else if (currentCycle_ >= 257 && currentCycle_ <= 320)
 	{
-		// Clear active sprite count.
-		activeSpriteCount_ = 0;
-
-		// Eval all 64 entries in OAM and try to find up to 8 sprites to render
+		// Fetch sprites to render from secondary OAM.
 		// for the next scanline.
-		u8 n = 0;
-		u8 m = 0;
-		while (n < 64)
+		const u8 spriteIndex = (currentCycle_ - 257) / 8;
+		if (spriteIndex < activeSpriteCount_)
 		{
-			const u16 oamAddr = (4 * n) + m;
-			const u8 sprY = primaryOam_.Read8(oamAddr);
-			const bool sprInRange = (sprY <= currentScanline_ && 
-									 static_cast<unsigned int>(sprY) + GetSpriteHeight() > currentScanline_);
-
-			// Check if we already have 8 sprites found and check for overflow if we do.
-			// Otherwise, check if sprite is in range. If H is set in PPUCTRL, sprite is 16 px high.
-			if (activeSpriteCount_ == 8)
+			auto& sprite = activeSprites_[spriteIndex];
+			const u8 sprAddr = spriteIndex * 4;
+
+			switch ((currentCycle_ - 257) % 8)
 			{
-				if (sprInRange)
-				{
-					// Set overflow and stop here.
-					NESHelper::SetRefBit(reg_.PPUSTATUS, NES_PPU_REG_PPUSTATUS_O_BIT);
-					break;
-				}
-				else
-				{
-					// @NOTE: The m increment is a hardware bug and emulates the
-					// bug where the O flag in PPUSTATUS is sometimes not set.
-					++m;
-					if (m > 3) // Make sure m doesn't increment above 3.
-						m = 0;
-				}
+			case 0:
+				sprite.y = secondaryOam_.Read8(sprAddr);
+				break;
+
+			case 1:
+				sprite.tileIndex = secondaryOam_.Read8(sprAddr + 1);
+				break;
+
+			case 2:
+				sprite.attributes = secondaryOam_.Read8(sprAddr + 2);
+				break;
+
+			case 3:
+				sprite.x = secondaryOam_.Read8(sprAddr + 3);
+				break;
+
+			// Fetch tile bitmap of sprite (probably 2 cycles per memory access).
+			case 5:
+				sprite.tileRow = FetchTileRow(
+					GetSpriteTileAddress(sprite.tileIndex),
+					currentScanline_ - sprite.y,
+					NESHelper::IsBitSet(sprite.attributes, 6),
+					NESHelper::IsBitSet(sprite.attributes, 7)
+				);
+				break;
+
+			case 7:
+				MergeTileRowHighPlane(sprite.tileRow, FetchTileRow(
+					GetSpriteTileAddress(sprite.tileIndex),
+					currentScanline_ - sprite.y,
+					NESHelper::IsBitSet(sprite.attributes, 6),
+					NESHelper::IsBitSet(sprite.attributes, 7)
+				));
+				break;
 			}
-			else if (sprInRange)
-			{
-				// Sprite is in range. Prepare the sprite for the secondary
-				// OAM fetch step (which is afterward the main eval step).
-				activeSprites_[activeSpriteCount_] = NESPPUSprite(n);
+		}
 
-				// Copy primary OAM entry to secondary OAM.
-				const u16 secondaryOamAddr = activeSpriteCount_ * 4;
+		// All of the sprites have been fetched after the last cycle, so draw them for the next scanline.
+		if (currentCycle_ == 320)
+			RasterizeSpriteLine();
+	}
+}
 
-				secondaryOam_.Write8(secondaryOamAddr, sprY);
-				for (u8 i = 1; i <= 3; ++i)
-					secondaryOam_.Write8(secondaryOamAddr + i, primaryOam_.Read8(oamAddr + i));
 
-				++activeSpriteCount_;
-			}
+void NESPPU::RebuildOAMScanlineMasks()
+{
+	oamScanlineMasks_.fill(0);
+	oamScanlineMasksSpriteHeight_ = GetSpriteHeight();
 
-			++n;
-		}
+	for (u8 n = 0; n < 64; ++n)
+		UpdateOAMScanlineMasks(n, primaryOam_.Read8(4 * n), true);
+}
 
-		// @NOTE: Secondary OAM always ends with Sprite 63's Y-position
-		// if it isn't already full (or before the $FFs from the init).
-		if (activeSpriteCount_ < 8)
-			secondaryOam_.Write8(activeSpriteCount_ * 4, primaryOam_.Read8(0xFC));
-	}
-	else if (currentCycle_ >= 257 && currentCycle_ <= 320)
+
+void NESPPU::EvaluateSprites()
+{
+	// Clear active sprite count.
+	activeSpriteCount_ = 0;
+
+	// The masks need rebuilding if H in PPUCTRL has changed since they were built.
+	if (oamScanlineMasksSpriteHeight_ != GetSpriteHeight())
+		RebuildOAMScanlineMasks();
+
+	// Find up to 8 sprites in OAM to render for the next scanline,
+	// using the mask of the sprites that are in range of this scanline.
+	u64 inRangeMask = oamScanlineMasks_[currentScanline_];
+	u8 n = 0;
+	while (inRangeMask != 0 && activeSpriteCount_ < 8)
 	{
-		// Fetch sprites to render from secondary OAM.
-		// for the next scanline.
-		const u8 spriteIndex = (currentCycle_ - 257) / 8;
-		if (spriteIndex >= activeSpriteCount_)
-			return;
+		n = NESHelper::GetLowestSetBitPos(inRangeMask);
+		inRangeMask &= inRangeMask - 1;
 
-		auto& sprite = activeSprites_[spriteIndex];
-		const u8 sprAddr = spriteIndex * 4;
+		// Sprite is in range. Prepare the sprite for the secondary
+		// OAM fetch step (which is afterward the main eval step).
+		activeSprites_[activeSpriteCount_] = NESPPUSprite(n);
 
-		switch ((currentCycle_ - 257) % 8)
-		{
-		case 0:
-			sprite.y = secondaryOam_.Read8(sprAddr);
-			break;
+		// Copy primary OAM entry to secondary OAM.
+		const u16 oamAddr = 4 * n;
+		const u16 secondaryOamAddr = activeSpriteCount_ * 4;
 
-		case 1:
-			sprite.tileIndex = secondaryOam_.Read8(sprAddr + 1);
-			break;
+		for (u8 i = 0; i <= 3; ++i)
+			secondaryOam_.Write8(secondaryOamAddr + i, primaryOam_.Read8(oamAddr + i));
 
-		case 2:
-			sprite.attributes = secondaryOam_.Read8(sprAddr + 2);
-			break;
+		++activeSpriteCount_;
+	}
 
-		case 3:
-			sprite.x = secondaryOam_.Read8(sprAddr + 3);
-			break;
+	// If 8 sprites were found, check the rest of OAM for overflow in the same way as the hardware.
+	// This has to read OAM directly, as the hardware doesn't only read Y-positions here.
+	if (activeSpriteCount_ == 8 && FindSpriteOverflow(n + 1, currentScanline_))
+		NESHelper::SetRefBit(reg_.PPUSTATUS, NES_PPU_REG_PPUSTATUS_O_BIT);
 
-		// Fetch tile bitmap of sprite (probably 2 cycles per memory access).
-		case 5:
-			sprite.tileBitmapLo = FetchTileBitmapLine(
-				GetSpriteTileAddress(sprite.tileIndex),
-				currentScanline_ - sprite.y,
-				NESHelper::IsBitSet(sprite.attributes, 6),
-				NESHelper::IsBitSet(sprite.attributes, 7)
-			);
-			break;
+	// @NOTE: Secondary OAM always ends with Sprite 63's Y-position
+	// if it isn't already full (or before the $FFs from the init).
+	if (activeSpriteCount_ < 8)
+		secondaryOam_.Write8(activeSpriteCount_ * 4, primaryOam_.Read8(0xFC));
+}
 
-		case 7:
-			sprite.tileBitmapHi = FetchTileBitmapLine(
-				GetSpriteTileAddress(sprite.tileIndex) + 8,
-				currentScanline_ - sprite.y,
-				NESHelper::IsBitSet(sprite.attributes, 6),
-				NESHelper::IsBitSet(sprite.attributes, 7)
-			);
-			break;
-		}
+
+bool NESPPU::FindSpriteOverflow(u8 n, unsigned int scanline) const
+{
+	u8 m = 0;
+	while (n < 64)
+	{
+		const u16 oamAddr = (4 * n) + m;
+		const u8 sprY = primaryOam_.Read8(oamAddr);
+		const bool sprInRange = (sprY <= scanline &&
+								 static_cast<unsigned int>(sprY) + GetSpriteHeight() > scanline);
+
+		if (sprInRange)
+			return true;
+
+		// @NOTE: The m increment is a hardware bug and emulates the
+		// bug where the O flag in PPUSTATUS is sometimes not set.
+		++m;
+		if (m > 3) // Make sure m doesn't increment above 3.
+			m = 0;
+
+		++n;
 	}
+
+	return false;
 }
 
 
 void NESPPU::TickRenderPixel()
 {
-	// Only render on visible scanlines.
-	if (currentScanline_ > 239)
+	// Only render on visible scanlines and the cycles that output pixels (1 - 256).
+	if (currentScanline_ > 239 || currentCycle_ > 256)
 		return;
 
 	// Assume no color to begin with for the background and sprite pixels.
-	u8 bgAttrib = 0;
 	u8 bgPixel = 0;
 
-	u8 sprAttrib = 0;
 	u8 sprPixel = 0;
 
 	if (IsRenderingEnabled())
@@ -506,77 +563,295 @@ void NESPPU::TickRenderPixel()
 		if (!(currentCycle_ <= 7 && !NESHelper::IsBitSet(reg_.PPUMASK, NES_PPU_REG_PPUMASK_m_BIT)) &&
 			NESHelper::IsBitSet(reg_.PPUMASK, NES_PPU_REG_PPUMASK_b_BIT))
 		{
-			const auto bgTilePixelX = (currentCycle_ % 8) + (xScroll_ & 7);
-			const auto bgTile = activeTiles_[(bgTilePixelX < 8 ? 1 : 0)];
-
-			// Get the color of the background pixel at this position.
-			bgAttrib = bgTile.atByte;
-			bgPixel = GetTileBitmapLinePixel(bgTile.tileBitmapHi, bgTile.tileBitmapLo, bgTilePixelX % 8);
+			// Get the palette address of the background pixel at this position.
+			bgPixel = bgShifters_.GetPixel((currentCycle_ % 8) + (xScroll_ & 7));
 		}
 
 		// Check if we should render sprite pixels
 		if (!(currentCycle_ <= 7 && !NESHelper::IsBitSet(reg_.PPUMASK, NES_PPU_REG_PPUMASK_M_BIT)) &&
 			NESHelper::IsBitSet(reg_.PPUMASK, NES_PPU_REG_PPUMASK_s_BIT))
 		{
-			// Loop through active sprites to see if any should be drawn.
-			for (u8 i = 0; i < activeSpriteCount_; ++i)
-			{
-				const auto& sprite = activeSprites_[i];
+			// Get the first opaque sprite pixel at this position from the sprite line.
+			if (activeSpriteCount_ != 0)
+				sprPixel = spriteLine_[currentCycle_ - 1];
 
-				if (sprite.x <= currentCycle_ && sprite.x + 8u > currentCycle_)
-				{
-					// Sprite is in range!
-					sprAttrib = sprite.attributes;
-					sprPixel = GetTileBitmapLinePixel(sprite.tileBitmapHi, sprite.tileBitmapLo,
-						currentCycle_ - sprite.x);
-
-					// If this is a transparent pixel, just continue to the next entry.
-					if (sprPixel == 0)
-						continue;
-
-					// Check for Sprite-0 hits. (Cannot happen on cycle >= 255 or cycle < 2).
-					if (sprite.GetPrimaryOAMIndex() == 0 && bgPixel != 0 && currentCycle_ < 255 && currentCycle_ >= 2)
-						NESHelper::SetRefBit(reg_.PPUSTATUS, NES_PPU_REG_PPUSTATUS_S_BIT);
-
-					// Check sprite priority - background flag is bit 5, we do not render this
-					// pixel of the sprite if the background flag is set and a background pixel is
-					// being drawn.
-					if (NESHelper::IsBitSet(sprite.attributes, 5) && bgPixel != 0)
-						sprPixel = 0;
-
-					break;
-				}
+			if (sprPixel != 0)
+			{
+				// Check for Sprite-0 hits.
+				if ((sprPixel & NES_PPU_SPRITE_LINE_SPRITE0_FLAG) != 0 && bgPixel != 0)
+					NESHelper::SetRefBit(reg_.PPUSTATUS, NES_PPU_REG_PPUSTATUS_S_BIT);
+
+				// Check sprite priority - we do not render this pixel of the sprite
+				// if it is behind the background and a background pixel is being drawn.
+				if ((sprPixel & NES_PPU_SPRITE_LINE_BEHIND_BG_FLAG) != 0 && bgPixel != 0)
+					sprPixel = 0;
 			}
 		}
 	}
 
+	// Skip resolving the color of the pixel if nothing is being output.
+	if (!isFrameOutputEnabled_)
+		return;
+
 	// Determine the color of the pixel to draw.
-	NESPPUColor pixelColor;
+	u16 pixel = NES_PPU_BLACK_PALETTE_INDEX;
 	if (sprPixel != 0)
 	{
-		// Use first 2 bits of attrib.
-		pixelColor = GetPPUPaletteColor(comm_->Read8(0x3F10 + (4 * (sprAttrib & 3)) + sprPixel));
+		// The sprite line holds the palette address of the pixel.
+		pixel = GetPalettePixels()[sprPixel & 0x1F];
 	}
 	else if (bgPixel != 0)
 	{
-		// Get the correct attrib for which corner the tile is on.
-		const bool isBottom = (((((vScroll_ & 0x60) >> 2) | ((vScroll_ >> 12) & 7)) % 32) >= 16);
-		const bool isRight = (((((vScroll_ & 3) << 3) + (xScroll_ & 7) + (currentCycle_ % 8)) % 32) < 16);
-		const u8 bgPixAttrib = (bgAttrib >> ((isBottom ? 4 : 0) + (isRight ? 2 : 0))) & 3;
-
-		pixelColor = GetPPUPaletteColor(comm_->Read8(0x3F00 + (4 * bgPixAttrib) + bgPixel));
+		// The attribute was resolved when the tile was fetched.
+		pixel = GetPalettePixels()[bgPixel];
 	}
 	else
 	{
 		// Get color from backdrop palette.
         // @NOTE: Reads from vScroll if rendering disabled and if vScroll in $3F00 - $3FFF range.
         if (IsRenderingEnabled())
-            pixelColor = GetPPUPaletteColor(comm_->Read8(0x3F00));
+            pixel = GetPalettePixels()[0];
         else if (vScroll_ >= 0x3F00 && vScroll_ <= 0x3FFF)
-            pixelColor = GetPPUPaletteColor(comm_->Read8(vScroll_));
+            pixel = GetPalettePixels()[vScroll_ & 0x1F];
     }
-    
-    debug_.setPixel(currentCycle_, currentScanline_, pixelColor.ToSFColor()); // @TODO: DEBUG!
+
+	frameBuffers_[backBufferIndex_][(currentScanline_ * NES_PPU_FRAME_WIDTH) + (currentCycle_ - 1)] = pixel;
+}
+
+
+NESPPUBGFetchLatches NESPPU::FetchBackgroundTile() const
+{
+	NESPPUBGFetchLatches tile;
+
+	tile.ntByte = comm_->Read8(0x2000 | (vScroll_ & 0xFFF));
+	tile.attrib = FetchBackgroundAttribute();
+
+	const u16 tileBmpAddr = GetBackgroundTileAddress(tile.ntByte) + ((vScroll_ >> 12) & 7);
+	tile.bitmapLo = comm_->Read8(tileBmpAddr);
+	tile.bitmapHi = comm_->Read8(tileBmpAddr + 8);
+
+	return tile;
+}
+
+
+void NESPPU::RasterizeSpriteLine()
+{
+	spriteLine_.fill(0);
+
+	// Earlier sprites have priority over later ones, so only the first opaque pixel at each position is kept.
+	for (u8 i = 0; i < activeSpriteCount_; ++i)
+	{
+		const auto& sprite = activeSprites_[i];
+
+		for (u8 spritePixelX = 0; spritePixelX < 8; ++spritePixelX)
+		{
+			// No sprites are drawn on cycle 256, as that is when sprites for the next scanline are evaluated.
+			const unsigned int cycle = sprite.x + spritePixelX;
+			if (cycle == 0 || cycle >= 256)
+				continue;
+
+			auto& linePixel = spriteLine_[cycle - 1];
+			const u8 sprPixel = sprite.tileRow[spritePixelX];
+			if (linePixel != 0 || sprPixel == 0)
+				continue;
+
+			linePixel = 0x10 + (4 * (sprite.attributes & 3)) + sprPixel;
+
+			if (NESHelper::IsBitSet(sprite.attributes, 5))
+				linePixel |= NES_PPU_SPRITE_LINE_BEHIND_BG_FLAG;
+
+			// Sprite-0 hits cannot happen on cycle >= 255 or cycle < 2.
+			if (sprite.GetPrimaryOAMIndex() == 0 && cycle < 255 && cycle >= 2)
+				linePixel |= NES_PPU_SPRITE_LINE_SPRITE0_FLAG;
+		}
+	}
+}
+
+
+void NESPPU::TickScanline()
+{
+	assert(currentScanline_ <= 239 && currentCycle_ == 0);
+
+	const auto frameLine = frameBuffers_[backBufferIndex_].begin() + (currentScanline_ * NES_PPU_FRAME_WIDTH);
+
+	if (!IsRenderingEnabled())
+	{
+		// Nothing is fetched or evaluated, so every pixel is the same color.
+		activeSpriteCount_ = 0;
+
+		if (isFrameOutputEnabled_)
+		{
+			u16 pixel = NES_PPU_BLACK_PALETTE_INDEX;
+			if (vScroll_ >= 0x3F00 && vScroll_ <= 0x3FFF)
+				pixel = GetPalettePixels()[vScroll_ & 0x1F];
+
+			std::fill(frameLine, frameLine + NES_PPU_FRAME_WIDTH, pixel);
+		}
+	}
+	else
+	{
+		// Secondary OAM is cleared on cycles 1 - 64.
+		for (u8 i = 0; i < 0x20; ++i)
+			secondaryOam_.Write8(i, 0xFF);
+
+		// Sprite-0 hits have to be checked for now, which needs the background pixels.
+		// Sprite 0 is always the first active sprite if it is on this scanline.
+		const bool checkSprite0Hit = (activeSpriteCount_ != 0 && activeSprites_[0].GetPrimaryOAMIndex() == 0 &&
+			NESHelper::IsBitSet(reg_.PPUMASK, NES_PPU_REG_PPUMASK_s_BIT) &&
+			!NESHelper::IsBitSet(reg_.PPUSTATUS, NES_PPU_REG_PPUSTATUS_S_BIT));
+
+		// If nothing is being output, the scanline only needs recording to check for a sprite-0 hit.
+		const bool needsRecord = (isFrameOutputEnabled_ || checkSprite0Hit);
+
+		auto& record = renderWorker_->GetRecord(currentScanline_);
+		if (needsRecord)
+		{
+			record.bgShifters = bgShifters_;
+			record.xScroll = xScroll_;
+			record.PPUMASK = reg_.PPUMASK;
+			record.hasSprites = (activeSpriteCount_ != 0);
+			if (record.hasSprites)
+				record.spriteLine = spriteLine_;
+		}
+
+		// Cycles 1 - 256: Fetch the next 32 tiles while drawing the current ones.
+		// The fetched tile only becomes active on the last cycle of each tile, so the fetches are done up front.
+		for (unsigned int tileCycle = 0; tileCycle < 256; tileCycle += 8)
+		{
+			const auto fetchedTile = FetchBackgroundTile();
+			if (needsRecord)
+				record.bgTiles[tileCycle / 8] = fetchedTile;
+
+			const unsigned int lastCycle = tileCycle + 8;
+			if (lastCycle == 256)
+				IncrementScrollY();
+			IncrementScrollX();
+			xIncdThisTick_ = yIncdThisTick_ = false;
+
+			// Sprites for the next scanline are evaluated on cycle 256.
+			if (lastCycle == 256)
+				EvaluateSprites();
+
+			bgShifters_.Reload(fetchedTile);
+		}
+
+		// The palettes can't change until the scanline has finished.
+		if (isFrameOutputEnabled_)
+			record.palettePixels = GetPalettePixels();
+
+		if (checkSprite0Hit)
+		{
+			// Nothing can read PPUSTATUS until the scanline has finished, so the sprite-0 hit flag can be set afterwards.
+			// The pixels are already composited here, so drawing them isn't worth handing to the render worker.
+			NESPPUCompositorLine compositedLine;
+			if (NESPPURenderWorker::CompositeScanline(record, compositedLine))
+				NESHelper::SetRefBit(reg_.PPUSTATUS, NES_PPU_REG_PPUSTATUS_S_BIT);
+
+			if (isFrameOutputEnabled_)
+			{
+				for (unsigned int x = 0; x < NES_PPU_FRAME_WIDTH; ++x)
+					frameLine[x] = record.palettePixels[compositedLine[x]];
+			}
+		}
+		else if (isFrameOutputEnabled_)
+			renderWorker_->Submit(currentScanline_, &frameLine[0]);
+
+		// Cycle 257: v: ....F.. ...EDCBA = t: ....F.. ...EDCBA
+		vScroll_ = (vScroll_ & 0x7BE0) | (tScroll_ & 0x41F);
+
+		// Cycles 257 - 320: Fetch the sprites to draw on the next scanline.
+		for (u8 i = 0; i < activeSpriteCount_; ++i)
+		{
+			auto& sprite = activeSprites_[i];
+			const u8 sprAddr = i * 4;
+
+			sprite.y = secondaryOam_.Read8(sprAddr);
+			sprite.tileIndex = secondaryOam_.Read8(sprAddr + 1);
+			sprite.attributes = secondaryOam_.Read8(sprAddr + 2);
+			sprite.x = secondaryOam_.Read8(sprAddr + 3);
+
+			const bool flipHoriz = NESHelper::IsBitSet(sprite.attributes, 6);
+			const bool flipVert = NESHelper::IsBitSet(sprite.attributes, 7);
+			sprite.tileRow = FetchTileRow(GetSpriteTileAddress(sprite.tileIndex),
+				currentScanline_ - sprite.y, flipHoriz, flipVert);
+		}
+
+		RasterizeSpriteLine();
+
+		// Cycles 321 - 336: Fetch the first two tiles of the next scanline.
+		// (The tiles fetched on cycles 257 - 320 are always replaced by these).
+		bgShifters_.Reload(FetchBackgroundTile());
+		IncrementScrollX();
+		xIncdThisTick_ = false;
+
+		bgShifters_.Reload(FetchBackgroundTile());
+		IncrementScrollX();
+		xIncdThisTick_ = false;
+
+		// Cycles 337 - 340: Start fetching the third tile.
+		bgFetchLatches_ = NESPPUBGFetchLatches();
+		bgFetchLatches_.ntByte = comm_->Read8(0x2000 | (vScroll_ & 0xFFF));
+		bgFetchLatches_.attrib = FetchBackgroundAttribute();
+	}
+
+	// Move on to the next scanline. (Nothing else is ticked every cycle, as timers are deadlines against elapsedCycles_).
+	elapsedCycles_ += 341;
+	currentCycle_ = 0;
+	++currentScanline_;
+}
+
+
+const NESPPUEmphasisPalettes& NESPPU::GetEmphasisPalettes()
+{
+	static const NESPPUEmphasisPalettes emphasisPalettes = []()
+	{
+		NESPPUEmphasisPalettes palettes;
+
+		for (u8 emphasis = 0; emphasis < 8; ++emphasis)
+		{
+			// Emphasis bits are red, green and blue from lowest to highest (NTSC).
+			// Each emphasized channel attenuates the other two.
+			std::array<double, 3> channelScale;
+			for (u8 channel = 0; channel < 3; ++channel)
+				channelScale[channel] = ((emphasis & ~(1 << channel)) != 0 ? NES_PPU_EMPHASIS_ATTENUATION : 1.0);
+
+			for (u8 i = 0; i < 0x40; ++i)
+			{
+				const auto& color = ppuPalette[i];
+				auto& emphasisColor = palettes[emphasis][i];
+
+				emphasisColor[0] = static_cast<u8>(color.r * channelScale[0]);
+				emphasisColor[1] = static_cast<u8>(color.g * channelScale[1]);
+				emphasisColor[2] = static_cast<u8>(color.b * channelScale[2]);
+				emphasisColor[3] = 0xFF;
+			}
+		}
+
+		return palettes;
+	}();
+
+	return emphasisPalettes;
+}
+
+
+void NESPPU::ConvertFrameToRGBA(const NESPPUFrameBuffer& frame, NESPPUFrameRGBA& rgba)
+{
+	const auto& emphasisPalettes = GetEmphasisPalettes();
+
+	for (std::size_t i = 0; i < frame.size(); ++i)
+	{
+		const auto& color = emphasisPalettes[(frame[i] >> 6) & 7][frame[i] & 0x3F];
+		std::copy(color.begin(), color.end(), rgba.begin() + (i * 4));
+	}
+}
+
+
+void NESPPU::UpdatePalettePixels()
+{
+	for (u8 i = 0; i < 0x20; ++i)
+		palettePixels_[i] = GetPPUPalettePixel(comm_->Read8(0x3F00 + i));
+
+	isPalettePixelsDirty_ = false;
 }
 
 
@@ -603,6 +878,14 @@ void NESPPU::Tick()
 				NESHelper::SetRefBit(reg_.PPUSTATUS, NES_PPU_REG_PPUSTATUS_V_BIT);
 			}
 
+			// The frame has been fully rendered by the start of V-BLANK, so present it (if it was output)
+			// once the render worker has finished drawing it.
+			if (currentScanline_ == 241 && currentCycle_ == 1 && isFrameOutputEnabled_)
+			{
+				renderWorker_->Finish();
+				backBufferIndex_ = 1 - backBufferIndex_;
+			}
+
 			if (currentScanline_ >= 241 && currentCycle_ >= 3 &&
 				NESHelper::IsBitSet(reg_.PPUSTATUS, NES_PPU_REG_PPUSTATUS_V_BIT) &&
 				NESHelper::IsBitSet(reg_.PPUCTRL, NES_PPU_REG_PPUCTRL_V_BIT) &&
@@ -663,16 +946,6 @@ void NESPPU::Tick()
 	++elapsedCycles_;
 	++currentCycle_;
 
-	// Decay the value inside of the internal data bus.
-	if (latches_.cyclesLeftUntilBusDecay > 0)
-		--latches_.cyclesLeftUntilBusDecay;
-	else
-		latches_.internalDataBusVal = 0;
-
-	// Update amount of cycles left to ignore writes to some registers.
-	if (reg_.writeIgnoreCyclesLeft > 0)
-		--reg_.writeIgnoreCyclesLeft;
-
 	ppuStatusReadThisTick_ = xIncdThisTick_ = yIncdThisTick_ = false;
 
 	// Check if we're at the end of this scanline (which is one cycle earlier (339)
@@ -687,8 +960,270 @@ void NESPPU::Tick()
 		{
 			currentScanline_ = 0;
 			isEvenFrame_ = !isEvenFrame_;
+			isFrameOutputEnabled_ = isNextFrameOutputEnabled_;
 			
 			++elapsedFrames_;
 		}
 	}
 }
+
+
+void NESPPU::CatchUp(u64 targetCycle)
+{
+	while (elapsedCycles_ < targetCycle)
+	{
+		// Nothing can access the PPU until we reach targetCycle, so whole visible scanlines can be rendered at once.
+		// Scanlines that are only partly caught up with (because of a register or mapper access mid-line) are ticked per cycle.
+		if (currentScanline_ <= 239 && currentCycle_ == 0 && targetCycle - elapsedCycles_ >= 341)
+			TickScanline();
+		else
+			Tick();
+	}
+}
+
+
+u64 NESPPU::GetFramePositionCycle(unsigned int scanline, unsigned int cycle) const
+{
+	// Positions inside of the frame, in cycles since cycle 0 of scanline 0.
+	// (Each scanline is 341 cycles long).
+	const unsigned int framePos = (currentScanline_ * 341) + currentCycle_;
+	const unsigned int targetPos = (scanline * 341) + cycle;
+
+	if (targetPos >= framePos)
+		return elapsedCycles_ + (targetPos - framePos);
+
+	// The position is in the next frame. This frame is one cycle shorter if the last cycle
+	// of the pre-render scanline (261) is going to be skipped on an odd frame.
+	const auto oddFrameSkip = (framePos <= (261 * 341) + 339 && !isEvenFrame_ && IsRenderingEnabled());
+	const unsigned int frameLength = (262 * 341) - (oddFrameSkip ? 1 : 0);
+
+	return elapsedCycles_ + (frameLength - framePos) + targetPos;
+}
+
+
+void NESPPU::GetPositionAtCycle(u64 targetCycle, unsigned int& scanline, unsigned int& cycle) const
+{
+	// Position inside of the current frame, in cycles since cycle 0 of scanline 0.
+	const unsigned int framePos = (currentScanline_ * 341) + currentCycle_;
+	u64 targetPos = framePos + (targetCycle > elapsedCycles_ ? targetCycle - elapsedCycles_ : 0);
+
+	// Skip over whole frames. Frames are one cycle shorter if the last cycle of the pre-render scanline (261)
+	// is skipped on an odd frame, which can't happen to the current frame if it has already passed that cycle.
+	bool isEvenFrame = isEvenFrame_;
+	bool isCurrentFrame = true;
+	while (true)
+	{
+		const auto oddFrameSkip = (!isEvenFrame && IsRenderingEnabled() &&
+			(!isCurrentFrame || framePos <= (261 * 341) + 339));
+		const unsigned int frameLength = (262 * 341) - (oddFrameSkip ? 1 : 0);
+
+		if (targetPos < frameLength)
+			break;
+
+		targetPos -= frameLength;
+		isEvenFrame = !isEvenFrame;
+		isCurrentFrame = false;
+	}
+
+	scanline = static_cast<unsigned int>(targetPos / 341);
+	cycle = static_cast<unsigned int>(targetPos % 341);
+}
+
+
+u64 NESPPU::NextEventCycle(NESPPUEventType type)
+{
+	switch (type)
+	{
+	case NESPPUEventType::VBLANK_START:
+		// V is set on cycle 1 of scanline 241.
+		return GetFramePositionCycle(241, 1);
+
+	case NESPPUEventType::NMI:
+		// A V-BLANK NMI can only be pulled if V in PPUCTRL is set.
+		if (!NESHelper::IsBitSet(reg_.PPUCTRL, NES_PPU_REG_PPUCTRL_V_BIT))
+			return NES_PPU_NO_EVENT_CYCLE;
+
+		if (currentScanline_ >= 241 && currentScanline_ <= 260 &&
+			NESHelper::IsBitSet(reg_.PPUSTATUS, NES_PPU_REG_PPUSTATUS_V_BIT) && !isNmiPulled_)
+		{
+			// NMI will be pulled as soon as we're on cycle 3 or later of a V-BLANK scanline.
+			return elapsedCycles_ + (currentCycle_ >= 3 ? 0 : 3 - currentCycle_);
+		}
+
+		// Otherwise, the earliest the NMI can be pulled is after V is set on cycle 1 of scanline 241.
+		return GetFramePositionCycle(241, 3);
+
+	case NESPPUEventType::SPRITE0_HIT:
+	case NESPPUEventType::SPRITE_OVERFLOW:
+		// The predictions are only valid until the flags are cleared or the predicted event happens.
+		if (!isEventPredictionValid_ || elapsedCycles_ > eventPredictionValidUntilCycle_)
+			PredictSpriteEvents();
+
+		return (type == NESPPUEventType::SPRITE0_HIT ? predictedSprite0HitCycle_ : predictedSpriteOverflowCycle_);
+
+	case NESPPUEventType::PRE_RENDER_CLEAR:
+		// Every flag in PPUSTATUS is cleared on cycle 1 of the pre-render scanline (261).
+		return GetFramePositionCycle(261, 1);
+
+	case NESPPUEventType::FRAME_END:
+		// The frame ends on the last cycle of the pre-render scanline (261), which is one
+		// cycle earlier (339) on odd frames if rendering is enabled.
+		return GetFramePositionCycle(261, (!isEvenFrame_ && IsRenderingEnabled() &&
+			(currentScanline_ != 261 || currentCycle_ <= 339)) ? 339 : 340);
+
+	default:
+		assert(false && "Unknown event type!");
+		return NES_PPU_NO_EVENT_CYCLE;
+	}
+}
+
+
+void NESPPU::PredictSpriteEvents()
+{
+	predictedSprite0HitCycle_ = predictedSpriteOverflowCycle_ = NES_PPU_NO_EVENT_CYCLE;
+
+	// Predictions are made up until the next pre-render clear (or until one of the events happens).
+	isEventPredictionValid_ = true;
+	eventPredictionValidUntilCycle_ = NextEventCycle(NESPPUEventType::PRE_RENDER_CLEAR);
+
+	// Sprites are only evaluated on visible scanlines while rendering is enabled.
+	// Between the end of the visible scanlines and the clear, neither flag can be set.
+	if (!IsRenderingEnabled() || (currentScanline_ >= 240 && (currentScanline_ != 261 || currentCycle_ <= 1)))
+		return;
+
+	// The masks need rebuilding if H in PPUCTRL has changed since they were built, same as for evaluation.
+	if (oamScanlineMasksSpriteHeight_ != GetSpriteHeight())
+		RebuildOAMScanlineMasks();
+
+	// The first visible scanline that hasn't started yet (which is scanline 0 of the next frame on the pre-render scanline).
+	const unsigned int nextScanline = (currentScanline_ == 261 ? 0 : currentScanline_ + 1);
+
+	// Sprite overflow is set when sprites are evaluated on cycle 256 of a visible scanline.
+	// The scanlines where 8 sprites are found are the only ones that can overflow.
+	if (!NESHelper::IsBitSet(reg_.PPUSTATUS, NES_PPU_REG_PPUSTATUS_O_BIT))
+	{
+		const unsigned int firstScanline = (currentScanline_ <= 239 && currentCycle_ <= 256 ? currentScanline_ : nextScanline);
+
+		for (unsigned int scanline = firstScanline; scanline <= 239; ++scanline)
+		{
+			u64 inRangeMask = oamScanlineMasks_[scanline];
+			for (u8 i = 0; i < 7 && inRangeMask != 0; ++i)
+				inRangeMask &= inRangeMask - 1;
+
+			if (inRangeMask != 0 && FindSpriteOverflow(NESHelper::GetLowestSetBitPos(inRangeMask) + 1, scanline))
+			{
+				predictedSpriteOverflowCycle_ = GetFramePositionCycle(scanline, 256);
+				break;
+			}
+		}
+	}
+
+	// Sprite-0 hits need both background and sprite rendering enabled.
+	if (NESHelper::IsBitSet(reg_.PPUSTATUS, NES_PPU_REG_PPUSTATUS_S_BIT) ||
+		!NESHelper::IsBitSet(reg_.PPUMASK, NES_PPU_REG_PPUMASK_b_BIT) ||
+		!NESHelper::IsBitSet(reg_.PPUMASK, NES_PPU_REG_PPUMASK_s_BIT))
+		return;
+
+	unsigned int firstOAMScanline = nextScanline;
+	if (currentScanline_ <= 239)
+	{
+		// The sprites on this scanline have already been drawn to the sprite line.
+		if (currentCycle_ <= 254 && activeSpriteCount_ != 0)
+			predictedSprite0HitCycle_ = PredictSprite0HitOnScanline(currentScanline_, currentCycle_, spriteLine_);
+
+		if (predictedSprite0HitCycle_ != NES_PPU_NO_EVENT_CYCLE || currentScanline_ == 239)
+		{
+			eventPredictionValidUntilCycle_ = std::min(eventPredictionValidUntilCycle_,
+				std::min(predictedSprite0HitCycle_, predictedSpriteOverflowCycle_));
+			return;
+		}
+
+		if (currentCycle_ > 320)
+		{
+			// The sprites for the next scanline have already been drawn to the sprite line too.
+			if (activeSpriteCount_ != 0)
+				predictedSprite0HitCycle_ = PredictSprite0HitOnScanline(nextScanline, 0, spriteLine_);
+
+			firstOAMScanline = nextScanline + 1;
+		}
+		else if (currentCycle_ > 256)
+		{
+			// The sprites for the next scanline are still being fetched, so assume the earliest possible hit if sprite 0 was found.
+			if (activeSpriteCount_ != 0 && activeSprites_[0].GetPrimaryOAMIndex() == 0)
+			{
+				predictedSprite0HitCycle_ = GetFramePositionCycle(nextScanline,
+					NESHelper::IsBitSet(reg_.PPUMASK, NES_PPU_REG_PPUMASK_m_BIT) &&
+					NESHelper::IsBitSet(reg_.PPUMASK, NES_PPU_REG_PPUMASK_M_BIT) ? 2 : 8);
+			}
+
+			firstOAMScanline = nextScanline + 1;
+		}
+	}
+	else // No sprites are evaluated on the pre-render scanline, so none are drawn on scanline 0.
+		firstOAMScanline = 1;
+
+	// Sprite 0 is always the first sprite found by evaluation, so it is drawn on every scanline after one that it's in range of.
+	for (unsigned int scanline = firstOAMScanline; scanline <= 239 && predictedSprite0HitCycle_ == NES_PPU_NO_EVENT_CYCLE; ++scanline)
+	{
+		if ((oamScanlineMasks_[scanline - 1] & 1) == 0)
+			continue;
+
+		const u8 sprY = primaryOam_.Read8(0);
+		const u8 sprTileIndex = primaryOam_.Read8(1);
+		const u8 sprAttributes = primaryOam_.Read8(2);
+		const u8 sprX = primaryOam_.Read8(3);
+
+		const auto tileRow = FetchTileRow(GetSpriteTileAddress(sprTileIndex), (scanline - 1) - sprY,
+			NESHelper::IsBitSet(sprAttributes, 6), NESHelper::IsBitSet(sprAttributes, 7));
+
+		// Draw sprite 0 to a sprite line in the same way as RasterizeSpriteLine().
+		NESPPUCompositorLine spriteLine;
+		spriteLine.fill(0);
+
+		for (u8 spritePixelX = 0; spritePixelX < 8; ++spritePixelX)
+		{
+			const unsigned int cycle = sprX + spritePixelX;
+			if (cycle >= 2 && cycle < 255 && tileRow[spritePixelX] != 0)
+				spriteLine[cycle - 1] = NES_PPU_SPRITE_LINE_SPRITE0_FLAG;
+		}
+
+		predictedSprite0HitCycle_ = PredictSprite0HitOnScanline(scanline, 0, spriteLine);
+	}
+
+	eventPredictionValidUntilCycle_ = std::min(eventPredictionValidUntilCycle_,
+		std::min(predictedSprite0HitCycle_, predictedSpriteOverflowCycle_));
+}
+
+
+u64 NESPPU::PredictSprite0HitOnScanline(unsigned int scanline, unsigned int firstCycle, const NESPPUCompositorLine& spriteLine) const
+{
+	// Pixels on cycles 1 - 7 are hidden unless both m and M in PPUMASK are set.
+	const bool isLeftClipped = (!NESHelper::IsBitSet(reg_.PPUMASK, NES_PPU_REG_PPUMASK_m_BIT) ||
+								!NESHelper::IsBitSet(reg_.PPUMASK, NES_PPU_REG_PPUMASK_M_BIT));
+
+	// Assume the background is opaque, so the first sprite-0 pixel is the earliest possible hit.
+	for (unsigned int cycle = std::max(firstCycle, isLeftClipped ? 8u : 2u); cycle <= 254; ++cycle)
+	{
+		if ((spriteLine[cycle - 1] & NES_PPU_SPRITE_LINE_SPRITE0_FLAG) != 0)
+			return GetFramePositionCycle(scanline, cycle);
+	}
+
+	return NES_PPU_NO_EVENT_CYCLE;
+}
+
+
+u64 NESPPU::GetNextSyncCycle()
+{
+	return std::min(NextEventCycle(NESPPUEventType::NMI), NextEventCycle(NESPPUEventType::FRAME_END));
+}
+
+
+u64 NESPPU::GetNextStatusChangeCycle()
+{
+	// V is set at the start of V-BLANK, and every flag is cleared on the pre-render scanline.
+	// Sprite-0 hit and sprite overflow can be set in-between if rendering is enabled.
+	return std::min(
+		std::min(NextEventCycle(NESPPUEventType::VBLANK_START), NextEventCycle(NESPPUEventType::PRE_RENDER_CLEAR)),
+		std::min(NextEventCycle(NESPPUEventType::SPRITE0_HIT), NextEventCycle(NESPPUEventType::SPRITE_OVERFLOW))
+	);
+}
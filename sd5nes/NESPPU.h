@@ -1,14 +1,17 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <limits>
+#include <memory>
 #include <sstream>
 
 #include <SFML/Graphics/Color.hpp>
-#include <SFML/Graphics/Image.hpp>
 
 #include "NESTypes.h"
 #include "NESHelper.h"
 #include "NESMemory.h"
+#include "NESCHRTileCache.h"
 
 /* Typedefs for the individual tables + typedef for holding both palettes (BG and Sprite). */
 typedef NESMemory<0x400> NESMemNameTable;
@@ -16,10 +19,11 @@ typedef NESMemory<0x20> NESMemPalettes;
 
 /**
 * Struct containing palette memory, name and attribute tables for the PPU.
+* The NES only has 2KB of VRAM for nametables - the last 2 are the extra 2KB of VRAM that four-screen carts provide.
 */
 struct NESPPUMemory
 {
-	std::array<NESMemNameTable, 2> nameTables;
+	std::array<NESMemNameTable, 4> nameTables;
 	NESMemPalettes paletteMem;
 };
 
@@ -80,6 +84,37 @@ const std::array<NESPPUColor, 0x40> ppuPalette = {
 	}
 };
 
+/* Width and height of the picture output by the PPU. */
+#define NES_PPU_FRAME_WIDTH 256
+#define NES_PPU_FRAME_HEIGHT 240
+
+/* Palette index used for pixels that are drawn black instead of from the palettes. */
+#define NES_PPU_BLACK_PALETTE_INDEX 0x0F
+
+/**
+* A frame of pixels output by the PPU.
+* Each pixel holds a 6-bit palette index (bits 0 - 5) and the color emphasis bits of PPUMASK (bits 6 - 8).
+*/
+typedef std::array<u16, NES_PPU_FRAME_WIDTH * NES_PPU_FRAME_HEIGHT> NESPPUFrameBuffer;
+
+/**
+* A frame converted to 32-bit RGBA pixels.
+*/
+typedef std::array<u8, NES_PPU_FRAME_WIDTH * NES_PPU_FRAME_HEIGHT * 4> NESPPUFrameRGBA;
+
+/**
+* The RGBA colors of the 64 palette indices, for each of the 8 combinations of the color emphasis bits.
+*/
+typedef std::array<std::array<std::array<u8, 4>, 0x40>, 8> NESPPUEmphasisPalettes;
+
+/* How much the color channels that aren't emphasized are attenuated by when color emphasis is used. */
+#define NES_PPU_EMPHASIS_ATTENUATION 0.746
+
+/**
+* A line of palette addresses ($00 - $1F) for each pixel of a scanline, as used by NESPPUCompositor.
+*/
+typedef std::array<u8, NES_PPU_FRAME_WIDTH> NESPPUCompositorLine;
+
 /* Positions of the different bits in the OAM Attribute field. */
 #define NES_PPU_OAM_ATTRIB_PALETTE_HI_BIT 0
 #define NES_PPU_OAM_ATTRIB_PALETTE_LO_BIT 1
@@ -129,6 +164,22 @@ enum class NESPPURegisterType
 	UNKNOWN
 };
 
+/**
+* The types of events that the PPU can predict the timing of.
+*/
+enum class NESPPUEventType
+{
+	VBLANK_START, // V in PPUSTATUS is set.
+	NMI, // The V-BLANK NMI is pulled.
+	SPRITE0_HIT, // S in PPUSTATUS is set.
+	SPRITE_OVERFLOW, // O in PPUSTATUS is set.
+	PRE_RENDER_CLEAR, // The flags in PPUSTATUS are cleared.
+	FRAME_END // The last tick of the frame.
+};
+
+/* Returned when an event is not predicted to happen. */
+#define NES_PPU_NO_EVENT_CYCLE std::numeric_limits<u64>::max()
+
 /**
 * The probability of certain bits in PPUSTATUS being set on power-on state.
 */
@@ -160,13 +211,13 @@ struct NESPPURegisters
 	/* OAM Read/Write Address (OAMADDR) */
 	u8 OAMADDR; 
 
-	/* Amount of cycles left to ignore writes to PPUCTRL, PPUMASK, PPUSCROLL and PPUADDR. */
-	unsigned int writeIgnoreCyclesLeft;
+	/* The elapsed PPU cycle count that writes to PPUCTRL, PPUMASK, PPUSCROLL and PPUADDR are ignored until. */
+	u64 writeIgnoreUntilCycle;
 
 	NESPPURegisters() :
 		PPUCTRL(0), PPUMASK(0), PPUSTATUS(0),
 		OAMADDR(0),
-		writeIgnoreCyclesLeft(0)
+		writeIgnoreUntilCycle(0)
 	{ }
 
 	inline std::string ToString() const
@@ -188,13 +239,14 @@ struct NESPPURegisters
 struct NESPPUSprite
 {
 	u8 x, y, tileIndex, attributes;
-	u8 tileBitmapHi, tileBitmapLo;
+	NESCHRTileRow tileRow;
 
 	NESPPUSprite(u8 primaryOamIndex = NES_INVALID_OAM_INDEX) :
 		primaryOamIndex_(primaryOamIndex),
-		x(0), y(0), tileIndex(0), attributes(0),
-		tileBitmapHi(0), tileBitmapLo(0)
-	{ }
+		x(0), y(0), tileIndex(0), attributes(0)
+	{
+		tileRow.fill(0);
+	}
 
 	/**
 	* Gets the original index in primary OAM of the Sprite.
@@ -206,23 +258,64 @@ private:
 };
 
 /**
-* Internal structure of a stored background tile's data.
+* Internal structure of the latches that a background tile is fetched into
+* before it is loaded into the shift registers.
 */
-struct NESPPUBGTileData
+struct NESPPUBGFetchLatches
 {
-	u8 ntByte, atByte;
-	u8 tileBitmapHi, tileBitmapLo;
+	u8 ntByte;
+	u8 attrib; // Palette bits of the tile's quadrant in its attribute byte.
+	u8 bitmapLo, bitmapHi;
 
-	NESPPUBGTileData(u8 nt, u8 at, u8 tileBmpHi, u8 tileBmpLo) :
-		ntByte(nt), atByte(at),
-		tileBitmapHi(tileBmpHi), tileBitmapLo(tileBmpLo)
+	NESPPUBGFetchLatches() :
+		ntByte(0), attrib(0),
+		bitmapLo(0), bitmapHi(0)
 	{ }
+};
+
+/**
+* Internal structure of the background shift registers. The high byte of each register holds the tile being drawn,
+* and the low byte holds the next tile. The attribute registers hold each palette bit repeated for all 8 pixels of the tile.
+*/
+struct NESPPUBGShiftRegisters
+{
+	u16 patternLo, patternHi;
+	u16 attribLo, attribHi;
 
-	NESPPUBGTileData() :
-		NESPPUBGTileData(0, 0, 0, 0)
+	NESPPUBGShiftRegisters() :
+		patternLo(0), patternHi(0),
+		attribLo(0), attribHi(0)
 	{ }
+
+	/**
+	* Shifts the next tile in to be drawn, and loads a fetched tile in as the next tile.
+	*/
+	inline void Reload(const NESPPUBGFetchLatches& latches)
+	{
+		patternLo = (patternLo << 8) | latches.bitmapLo;
+		patternHi = (patternHi << 8) | latches.bitmapHi;
+		attribLo = (attribLo << 8) | ((latches.attrib & 1) != 0 ? 0xFF : 0);
+		attribHi = (attribHi << 8) | ((latches.attrib & 2) != 0 ? 0xFF : 0);
+	}
+
+	/**
+	* Gets the palette address of a pixel, or 0 if the pixel is transparent.
+	* pixelX is the position of the pixel from the left of the tile being drawn (0 - 15, including fine X).
+	*/
+	inline u8 GetPixel(unsigned int pixelX) const
+	{
+		const unsigned int bit = 15 - pixelX;
+		const u8 pixel = (((patternHi >> bit) & 1) << 1) | ((patternLo >> bit) & 1);
+		if (pixel == 0)
+			return 0;
+
+		return (((((attribHi >> bit) & 1) << 1) | ((attribLo >> bit) & 1)) << 2) | pixel;
+	}
 };
 
+/* The amount of PPU cycles that elapse for every CPU cycle (NTSC). */
+#define NES_PPU_CYCLES_PER_CPU_CYCLE 3
+
 /* The amount of PPU cycles it takes for the value inside the internal data bus to decay. */
 #define NES_PPU_DATA_BUS_DECAY_CYCLES 357368
 
@@ -234,19 +327,21 @@ struct NESPPULatches
 	/* The value stored in the internal data bus. */
 	u8 internalDataBusVal;
 
-	/* Amount of cycles left until the value in the internal data bus decays away. */
-	unsigned int cyclesLeftUntilBusDecay;
+	/* The elapsed PPU cycle count that the value in the internal data bus decays away at. */
+	u64 busDecayCycle;
 
 	/* The state of the address latch used by PPUSCROLL and PPUADDR. */
 	bool isAddressLatchOn;
 
 	NESPPULatches() :
 		internalDataBusVal(0),
-		cyclesLeftUntilBusDecay(0),
+		busDecayCycle(0),
 		isAddressLatchOn(false)
 	{ }
 };
 
+class NESPPURenderWorker;
+
 /**
 * Interface for allowing the PPU to communicate with other devices.
 */
@@ -257,6 +352,11 @@ public:
 
 	virtual void PullNMI() = 0;
 	virtual std::array<u8, 0x100> OAMDMARead(u8 addrPage) = 0;
+
+	/**
+	* Gets the decoded pattern table tile at the specified address ($0000 - $1FFF).
+	*/
+	virtual const NESCHRDecodedTile& GetDecodedCHRTile(u16 addr) = 0;
 };
 
 /**
@@ -265,7 +365,7 @@ public:
 class NESPPU
 {
 public:
-	explicit NESPPU(sf::Image& debug);
+	NESPPU();
 	~NESPPU();
 
 	/**
@@ -288,6 +388,41 @@ public:
 	*/
 	void Tick();
 
+	/**
+	* Ticks the PPU until its elapsed cycle count reaches targetCycle.
+	*/
+	void CatchUp(u64 targetCycle);
+
+	/**
+	* Predicts the elapsed PPU cycle count at the start of the tick where the next event of the specified type happens,
+	* assuming that none of the PPU's registers are written to in the meantime.
+	* Returns NES_PPU_NO_EVENT_CYCLE if the event isn't predicted to happen.
+	* Sprite-0 hits and sprite overflows are only predicted up until the next pre-render clear.
+	* @NOTE Sprite-0 hits are predicted from OAM and CHR alone (the background is assumed to be opaque),
+	* so the predicted hit may be earlier than the actual hit, but it will never be later.
+	*/
+	u64 NextEventCycle(NESPPUEventType type);
+
+	/**
+	* Invalidates the predicted sprite events. Must be called if CHR memory is changed outside of the
+	* PPU's registers (such as by switching CHR banks).
+	* Writes to the PPU's registers invalidate them automatically.
+	*/
+	inline void InvalidateEventPrediction() { isEventPredictionValid_ = false; }
+
+	/**
+	* Gets the elapsed PPU cycle count at the start of the earliest upcoming tick that could affect
+	* other devices without any of its registers first being accessed.
+	* This is either the earliest tick that could pull a V-BLANK NMI, or the tick that ends the frame.
+	*/
+	u64 GetNextSyncCycle();
+
+	/**
+	* Gets the elapsed PPU cycle count at the start of the earliest upcoming tick that could change
+	* the value of PPUSTATUS (other than by reading it).
+	*/
+	u64 GetNextStatusChangeCycle();
+
 	/**
 	* Writes to the specified PPU register.
 	*/
@@ -318,6 +453,27 @@ public:
 	*/
 	inline bool IsRenderingEnabled() const { return ((reg_.PPUMASK & 0x18) != 0); }
 
+	/**
+	* Sets whether or not the pixels of the frames after the current one are output to the frame buffer.
+	* If disabled, the PPU still fetches and evaluates everything that affects PPUSTATUS, but skips resolving the color of
+	* every pixel and doesn't present the frame at the start of V-BLANK (so the front buffer keeps the last frame that was output).
+	* Used for skipping frames that nobody will see. Only takes effect at the start of the next frame, so that frames are never partly output.
+	*/
+	inline void SetNextFrameOutputEnabled(bool isEnabled) { isNextFrameOutputEnabled_ = isEnabled; }
+
+	/**
+	* Returns whether or not the pixels of the current frame are output to the frame buffer.
+	*/
+	inline bool IsFrameOutputEnabled() const { return isFrameOutputEnabled_; }
+
+	/**
+	* Gets the value in the internal data bus, which is 0 if it has decayed away.
+	*/
+	inline u8 GetInternalDataBusValue() const
+	{
+		return (elapsedCycles_ < latches_.busDecayCycle ? latches_.internalDataBusVal : 0);
+	}
+
 	/**
 	* Gets the number of elapsed frames since reset / power.
 	*/
@@ -326,11 +482,43 @@ public:
 	/**
 	* Gets the number of elapsed PPU cycles since reset / power.
 	*/
-	inline unsigned int GetElapsedCyclesCount() const { return elapsedCycles_; }
+	inline u64 GetElapsedCyclesCount() const { return elapsedCycles_; }
 
-private:
-	sf::Image& debug_; // @TODO DEBUG!!
+	/**
+	* Gets the scanline that the next tick is on.
+	*/
+	inline unsigned int GetCurrentScanline() const { return currentScanline_; }
+
+	/**
+	* Gets the cycle of the current scanline that the next tick is on.
+	*/
+	inline unsigned int GetCurrentCycle() const { return currentCycle_; }
+
+	/**
+	* Gets the scanline and cycle that the PPU will be on at the start of the tick at the specified elapsed PPU cycle count,
+	* without ticking the PPU. Assumes that rendering stays enabled or disabled until then (which decides whether or not
+	* odd frames skip a cycle). Cycle counts that have already elapsed give the current position.
+	*/
+	void GetPositionAtCycle(u64 targetCycle, unsigned int& scanline, unsigned int& cycle) const;
+
+	/**
+	* Gets the last frame that was fully rendered.
+	* The buffers are swapped at the start of V-BLANK, so this doesn't change while the next frame is being rendered.
+	*/
+	inline const NESPPUFrameBuffer& GetFrontBuffer() const { return frameBuffers_[1 - backBufferIndex_]; }
+
+	/**
+	* Converts the palette indices of a frame into RGBA colors, applying their color emphasis bits.
+	*/
+	static void ConvertFrameToRGBA(const NESPPUFrameBuffer& frame, NESPPUFrameRGBA& rgba);
 
+	/**
+	* Gets the precomputed RGBA colors of every palette index and color emphasis combination.
+	* Indexed by the emphasis bits (bits 6 - 8 of a frame buffer pixel) and then by the palette index.
+	*/
+	static const NESPPUEmphasisPalettes& GetEmphasisPalettes();
+
+private:
 	INESPPUCommunicationsInterface* comm_;
 
 	NESPPURegisters reg_;
@@ -339,8 +527,13 @@ private:
 	NESMemory<0x100> primaryOam_;
 	NESMemory<0x20> secondaryOam_;
 
+	// For each visible scanline, a mask of the sprites in primary OAM that are in range of it
+	// (bit n is set for sprite n). Built for sprites of oamScanlineMasksSpriteHeight_ pixels high.
+	std::array<u64, NES_PPU_FRAME_HEIGHT> oamScanlineMasks_;
+	u8 oamScanlineMasksSpriteHeight_;
+
 	unsigned int elapsedFrames_;
-	unsigned int elapsedCycles_;
+	u64 elapsedCycles_;
 
 	unsigned int currentScanline_;
 	unsigned int currentCycle_;
@@ -356,14 +549,114 @@ private:
 	// Buffered data of PPUDATA.
 	u8 ppuDataBuffered_;
 
-	std::array<NESPPUBGTileData, 2> activeTiles_;
-	NESPPUBGTileData bufferingTile_;
+	NESPPUBGShiftRegisters bgShifters_;
+	NESPPUBGFetchLatches bgFetchLatches_;
 
 	u8 activeSpriteCount_;
 	std::array<NESPPUSprite, 8> activeSprites_;
 
+	// The pixels of the active sprites, in the sprite line format used by NESPPUCompositor.
+	// Only valid while activeSpriteCount_ isn't 0.
+	NESPPUCompositorLine spriteLine_;
+
 	bool isEvenFrame_;
 
+	// The frame being rendered (back) and the last fully rendered frame (front).
+	std::array<NESPPUFrameBuffer, 2> frameBuffers_;
+	u8 backBufferIndex_;
+	bool isFrameOutputEnabled_, isNextFrameOutputEnabled_;
+
+	// Draws the pixels of scanlines rendered by TickScanline() into the back buffer on its own thread.
+	// Scanlines ticked per-cycle are still drawn by the PPU itself.
+	std::unique_ptr<NESPPURenderWorker> renderWorker_;
+
+	// Predicted cycles of the next sprite-0 hit and sprite overflow, which stay valid until
+	// eventPredictionValidUntilCycle_ is reached or a register is written to.
+	bool isEventPredictionValid_;
+	u64 eventPredictionValidUntilCycle_;
+	u64 predictedSprite0HitCycle_, predictedSpriteOverflowCycle_;
+
+	// The frame buffer pixels of the 32 palette entries, for the current palettes and PPUMASK.
+	// Only rebuilt after palette memory or the greyscale and emphasis bits of PPUMASK have changed.
+	std::array<u16, 0x20> palettePixels_;
+	bool isPalettePixelsDirty_;
+
+	/**
+	* Gets the frame buffer pixels of the 32 palette entries, rebuilding them first if needed.
+	*/
+	inline const std::array<u16, 0x20>& GetPalettePixels()
+	{
+		if (isPalettePixelsDirty_)
+			UpdatePalettePixels();
+
+		return palettePixels_;
+	}
+
+	/**
+	* Rebuilds the frame buffer pixels of the 32 palette entries.
+	*/
+	void UpdatePalettePixels();
+
+	/**
+	* Writes to primary OAM while keeping the scanline masks of the sprites up to date.
+	*/
+	inline void WritePrimaryOAM(u8 addr, u8 val)
+	{
+		// Only writes to the Y-position of a sprite can change which scanlines it is in range of.
+		if ((addr & 3) == 0)
+		{
+			UpdateOAMScanlineMasks(addr / 4, primaryOam_.Read8(addr), false);
+			UpdateOAMScanlineMasks(addr / 4, val, true);
+		}
+
+		primaryOam_.Write8(addr, val);
+	}
+
+	/**
+	* Sets or clears the bit of a sprite with Y-position sprY in the masks of the scanlines that it is in range of.
+	*/
+	inline void UpdateOAMScanlineMasks(u8 spriteIndex, u8 sprY, bool isInRange)
+	{
+		const unsigned int endScanline = std::min<unsigned int>(sprY + oamScanlineMasksSpriteHeight_, NES_PPU_FRAME_HEIGHT);
+		const u64 spriteBit = static_cast<u64>(1) << spriteIndex;
+
+		for (unsigned int i = sprY; i < endScanline; ++i)
+		{
+			if (isInRange)
+				oamScanlineMasks_[i] |= spriteBit;
+			else
+				oamScanlineMasks_[i] &= ~spriteBit;
+		}
+	}
+
+	/**
+	* Rebuilds the scanline masks of every sprite in primary OAM for the current sprite height.
+	*/
+	void RebuildOAMScanlineMasks();
+
+	/**
+	* Emulates the hardware's buggy search for a 9th sprite in range of a scanline, which
+	* starts at sprite n of OAM after 8 sprites have been found. Returns true if one was found.
+	*/
+	bool FindSpriteOverflow(u8 n, unsigned int scanline) const;
+
+	/**
+	* Gets the elapsed PPU cycle count at the start of the tick at the specified position.
+	* The position is in the next frame if the current frame has already passed it.
+	*/
+	u64 GetFramePositionCycle(unsigned int scanline, unsigned int cycle) const;
+
+	/**
+	* Predicts the next sprite-0 hit and sprite overflow.
+	*/
+	void PredictSpriteEvents();
+
+	/**
+	* Predicts the cycle of the earliest sprite-0 hit on a visible scanline, from the pixels of sprite 0 that are
+	* drawn on it (in the sprite line format) starting from firstCycle. Returns NES_PPU_NO_EVENT_CYCLE if there isn't one.
+	*/
+	u64 PredictSprite0HitOnScanline(unsigned int scanline, unsigned int firstCycle, const NESPPUCompositorLine& spriteLine) const;
+
 	/**
 	* Gets the height of sprites as defined in H in PPUCTRL.
 	*/
@@ -396,22 +689,11 @@ private:
 	}
 
 	/**
-	* Gets the color of a tile bitmap line's pixel at a specified position.
-	* pos cannot be above 7.
-	*/
-	inline u8 GetTileBitmapLinePixel(u8 tileBmpHi, u8 tileBmpLo, u8 pos) const
-	{
-		assert(pos < 8);
-
-		return (((tileBmpHi >> (7 - pos)) & 1) << 1) | (tileBmpLo >> (7 - pos)) & 1;
-	}
-
-	/**
-	* Gets a tile bitmap line while respecting horizontal and vertical flipping.
+	* Gets a decoded tile row while respecting horizontal and vertical flipping.
 	* Also supports tiles for sprites of 16 height.
 	* lineNum should be in the range 0 to 15.
 	*/
-	inline u8 FetchTileBitmapLine(u16 tileAddr, u8 lineNum, bool flipHoriz, bool flipVert) const
+	inline NESCHRTileRow FetchTileRow(u16 tileAddr, u8 lineNum, bool flipHoriz, bool flipVert) const
 	{
 		assert(lineNum < 16);
 
@@ -419,9 +701,42 @@ private:
 		if (flipVert)
 			lineNum = (NESHelper::IsBitSet(reg_.PPUCTRL, NES_PPU_REG_PPUCTRL_H_BIT) ? 15 : 7) - lineNum;
 
-		const u16 tileBmpAddr = tileAddr + (lineNum >= 8 ? 8 : 0) + lineNum;
-		const u8 tileBitmapLine = comm_->Read8(tileBmpAddr);
-		return (flipHoriz ? NESHelper::ReverseBits(tileBitmapLine) : tileBitmapLine);
+		if (lineNum < 16)
+		{
+			// Lines 8 - 15 are in the next tile.
+			const auto& tile = comm_->GetDecodedCHRTile(tileAddr + (lineNum >= 8 ? 16 : 0));
+			return (flipHoriz ? tile.flippedRows[lineNum & 7] : tile.rows[lineNum & 7]);
+		}
+
+		// @NOTE: The line can wrap around if the sprite height was changed after the sprite was evaluated.
+		// The bitplanes won't line up with a tile in that case, so read them directly instead of using the cache.
+		const u16 tileBmpAddr = tileAddr + 8 + lineNum;
+		const u8 tileBitmapLo = comm_->Read8(tileBmpAddr);
+		const u8 tileBitmapHi = comm_->Read8(tileBmpAddr + 8);
+		return (flipHoriz ?
+			NESCHRTileCache::DecodeRow(NESHelper::ReverseBits(tileBitmapLo), NESHelper::ReverseBits(tileBitmapHi)) :
+			NESCHRTileCache::DecodeRow(tileBitmapLo, tileBitmapHi));
+	}
+
+	/**
+	* Replaces the high bitplane of a tile row with the high bitplane of hiRow.
+	* Used when the low and high bitplanes are fetched on separate cycles, as the
+	* pattern table address could have changed in-between.
+	*/
+	inline void MergeTileRowHighPlane(NESCHRTileRow& row, const NESCHRTileRow& hiRow) const
+	{
+		for (u8 i = 0; i < 8; ++i)
+			row[i] = (row[i] & 1) | (hiRow[i] & 2);
+	}
+
+	/**
+	* Gets the frame buffer pixel of a PPU palette value. Considers bit G in PPUMASK for greyscale colors,
+	* and stores the color emphasis bits of PPUMASK alongside the palette index.
+	*/
+	inline u16 GetPPUPalettePixel(u8 palette) const
+	{
+		const u8 paletteIndex = (NESHelper::IsBitSet(reg_.PPUMASK, NES_PPU_REG_PPUMASK_G_BIT) ? palette & 0x30 : palette & 0x3F);
+		return paletteIndex | ((reg_.PPUMASK & 0xE0) << 1);
 	}
 
 	/**
@@ -469,5 +784,41 @@ private:
 	* Handles the rendering of pixels for this tick.
 	*/
 	void TickRenderPixel();
+
+	/**
+	* Ticks the PPU for an entire visible scanline, starting from its first cycle.
+	* Has the same result as ticking each cycle of the scanline individually, but
+	* only works when nothing else can access the PPU until the scanline has finished.
+	* The pixels of the scanline are recorded and left for the render worker to draw.
+	*/
+	void TickScanline();
+
+	/**
+	* Evaluates which sprites in OAM are in range of the next scanline (on cycle 256 of a visible scanline).
+	*/
+	void EvaluateSprites();
+
+	/**
+	* Fetches the palette bits of the background tile at v from its attribute byte.
+	*/
+	inline u8 FetchBackgroundAttribute() const
+	{
+		const u8 atByte = comm_->Read8(0x23C0 | (vScroll_ & 0xC00) | ((vScroll_ >> 4) & 0x38) | ((vScroll_ >> 2) & 7));
+
+		// Each attribute byte covers 4x4 tiles. Bit 1 of coarse Y and coarse X selects the 2x2 quadrant that the tile is in.
+		return (atByte >> (((vScroll_ >> 4) & 4) | (vScroll_ & 2))) & 3;
+	}
+
+	/**
+	* Fetches the data of the background tile at v.
+	*/
+	NESPPUBGFetchLatches FetchBackgroundTile() const;
+
+	/**
+	* Draws the active sprites into the sprite line once they have been fetched, keeping
+	* the first opaque sprite pixel for each cycle of the next scanline.
+	* PPUMASK isn't considered, as it can change before the sprites are drawn.
+	*/
+	void RasterizeSpriteLine();
 };
 
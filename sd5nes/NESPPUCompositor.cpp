@@ -0,0 +1,68 @@
+#include "NESPPUCompositor.h"
+#include "NESHelper.h"
+
+#ifdef NES_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+
+#ifdef NES_HAS_SSE2
+
+bool NESPPUCompositor::CompositeLine(const NESPPUCompositorLine& bgLine, const NESPPUCompositorLine& spriteLine, NESPPUCompositorLine& outLine)
+{
+	static_assert(NES_PPU_FRAME_WIDTH % 16 == 0, "Line width must be a multiple of the SSE2 vector width!");
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i paletteMask = _mm_set1_epi8(0x1F);
+	const __m128i behindFlag = _mm_set1_epi8(NES_PPU_SPRITE_LINE_BEHIND_BG_FLAG);
+	const __m128i sprite0Flag = _mm_set1_epi8(NES_PPU_SPRITE_LINE_SPRITE0_FLAG);
+
+	__m128i sprite0Hits = zero;
+
+	for (std::size_t i = 0; i < NES_PPU_FRAME_WIDTH; i += 16)
+	{
+		const __m128i bg = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&bgLine[i]));
+		const __m128i spr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&spriteLine[i]));
+
+		const __m128i bgTransparent = _mm_cmpeq_epi8(bg, zero);
+		const __m128i sprTransparent = _mm_cmpeq_epi8(spr, zero);
+		const __m128i sprBehind = _mm_cmpeq_epi8(_mm_and_si128(spr, behindFlag), behindFlag);
+		const __m128i sprIsSprite0 = _mm_cmpeq_epi8(_mm_and_si128(spr, sprite0Flag), sprite0Flag);
+
+		// Sprite-0 hits happen when an opaque sprite-0 pixel overlaps an opaque background pixel.
+		sprite0Hits = _mm_or_si128(sprite0Hits, _mm_andnot_si128(bgTransparent, sprIsSprite0));
+
+		// Draw the background pixel if the sprite pixel is transparent, or if it is behind an opaque background pixel.
+		const __m128i drawBg = _mm_or_si128(sprTransparent, _mm_andnot_si128(bgTransparent, sprBehind));
+		const __m128i out = _mm_or_si128(_mm_and_si128(drawBg, bg), _mm_andnot_si128(drawBg, _mm_and_si128(spr, paletteMask)));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&outLine[i]), out);
+	}
+
+	return (_mm_movemask_epi8(sprite0Hits) != 0);
+}
+
+#else
+
+bool NESPPUCompositor::CompositeLine(const NESPPUCompositorLine& bgLine, const NESPPUCompositorLine& spriteLine, NESPPUCompositorLine& outLine)
+{
+	bool sprite0Hit = false;
+
+	for (std::size_t i = 0; i < NES_PPU_FRAME_WIDTH; ++i)
+	{
+		const u8 bg = bgLine[i];
+		const u8 spr = spriteLine[i];
+
+		if ((spr & NES_PPU_SPRITE_LINE_SPRITE0_FLAG) != 0 && bg != 0)
+			sprite0Hit = true;
+
+		if (spr == 0 || ((spr & NES_PPU_SPRITE_LINE_BEHIND_BG_FLAG) != 0 && bg != 0))
+			outLine[i] = bg;
+		else
+			outLine[i] = spr & 0x1F;
+	}
+
+	return sprite0Hit;
+}
+
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "NESTypes.h"
+#include "NESPPU.h"
+
+/* Flags stored alongside the palette address of a pixel in a sprite line. */
+#define NES_PPU_SPRITE_LINE_BEHIND_BG_FLAG 0x20
+#define NES_PPU_SPRITE_LINE_SPRITE0_FLAG 0x40
+
+/**
+* Contains functions for compositing the background and sprite pixels of a scanline.
+* In background lines, 0 is a transparent pixel.
+* In sprite lines, 0 is a transparent pixel, and opaque pixels can also have the NES_PPU_SPRITE_LINE flags set.
+* The sprite-0 flag should only be set for pixels where a sprite-0 hit is possible.
+*/
+namespace NESPPUCompositor
+{
+	/**
+	* Combines a background line and a sprite line into the palette addresses of the final pixels,
+	* where transparent pixels use the backdrop color ($00).
+	* Returns true if a sprite-0 hit happened anywhere on the line.
+	*/
+	bool CompositeLine(const NESPPUCompositorLine& bgLine, const NESPPUCompositorLine& spriteLine, NESPPUCompositorLine& outLine);
+}
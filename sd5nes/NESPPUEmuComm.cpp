@@ -8,6 +8,8 @@ mmc_(&mmc),
 ntMirror_(ntMirror)
 {
 	assert(ntMirror != NESNameTableMirroringType::UNKNOWN);
+
+	UpdateNameTablePages();
 }
 
 
@@ -16,26 +18,41 @@ NESPPUEmuComm::~NESPPUEmuComm()
 }
 
 
-std::size_t NESPPUEmuComm::GetNameTableIndex(u16 addr) const
+void NESPPUEmuComm::UpdateNameTablePages() const
 {
-	switch (ntMirror_)
+	for (std::size_t i = 0; i < nameTablePages_.size(); ++i)
 	{
-	case NESNameTableMirroringType::VERTICAL:
-		return (addr & 0x7FF) / 0x400;
-
-	case NESNameTableMirroringType::HORIZONTAL:
-		return (addr & 0xFFF) / 0x800;
-
-	case NESNameTableMirroringType::ONE_SCREEN:
-		return 0;
-
-	case NESNameTableMirroringType::FOUR_SCREEN:
-		return 0; // @TODO NOT IMPLEMENTED YET!
-
-	default:
-		assert("Invalid name table mirror type!" && false);
-		return NES_INVALID_NAME_TABLE_INDEX;
+		std::size_t nameTableIndex;
+
+		switch (ntMirror_)
+		{
+		case NESNameTableMirroringType::VERTICAL:
+			nameTableIndex = i & 1;
+			break;
+
+		case NESNameTableMirroringType::HORIZONTAL:
+			nameTableIndex = i >> 1;
+			break;
+
+		case NESNameTableMirroringType::ONE_SCREEN:
+			nameTableIndex = 0;
+			break;
+
+		case NESNameTableMirroringType::FOUR_SCREEN:
+			// Every page has its own nametable, using the cart's extra VRAM for the last 2.
+			nameTableIndex = i;
+			break;
+
+		default:
+			assert("Invalid name table mirror type!" && false);
+			nameTableIndex = 0;
+			break;
+		}
+
+		nameTablePages_[i] = &mem_.nameTables[nameTableIndex];
 	}
+
+	nameTablePagesMirror_ = ntMirror_;
 }
 
 
@@ -62,7 +79,7 @@ void NESPPUEmuComm::Write8(u16 addr, u8 val)
 	if (addr < 0x2000) // Pattern tables
 		mmc_->Write8(addr, val);
 	else if (addr < 0x3F00) // Name tables
-		mem_.nameTables[GetNameTableIndex(addr)].Write8(addr & 0x3FF, val);
+		GetNameTablePage(addr).Write8(addr & 0x3FF, val);
 	else // Palette memory
 	{
 		mem_.paletteMem.Write8(addr & 0x1F, val);
@@ -81,7 +98,7 @@ u8 NESPPUEmuComm::Read8(u16 addr) const
 	if (addr < 0x2000) // Pattern tables
 		return mmc_->Read8(addr);
 	else if (addr < 0x3F00) // Name tables
-		return mem_.nameTables[GetNameTableIndex(addr)].Read8(addr & 0x3FF);
+		return GetNameTablePage(addr).Read8(addr & 0x3FF);
 	else // Palette memory
 		return mem_.paletteMem.Read8(addr & 0x1F);
 }
\ No newline at end of file
@@ -4,8 +4,6 @@
 #include "NESCPU.h"
 #include "NESMMC.h"
 
-#define NES_INVALID_NAME_TABLE_INDEX -1
-
 /**
 * Communication interface allowing the PPU to communicate with
 * its memory and the CPU.
@@ -26,6 +24,11 @@ public:
 	*/
 	std::array<u8, 0x100> OAMDMARead(u8 addrPage) override;
 
+	/**
+	* Gets the decoded pattern table tile at the specified address from the MMC's tile cache.
+	*/
+	inline const NESCHRDecodedTile& GetDecodedCHRTile(u16 addr) override { return mmc_->GetDecodedCHRTile(addr & 0x1FFF); }
+
 	void Write8(u16 addr, u8 val) override;
 	u8 Read8(u16 addr) const override;
 
@@ -34,12 +37,28 @@ private:
 	INESMMC* mmc_;
 	const NESNameTableMirroringType& ntMirror_;
 
+	// The nametable mapped to each $400 page of $2000 - $2FFF, for the mirroring type in nameTablePagesMirror_.
+	// These are only remapped when the MMC changes the mirroring type, so they are updated from the const Read8().
+	mutable std::array<NESMemNameTable*, 4> nameTablePages_;
+	mutable NESNameTableMirroringType nameTablePagesMirror_;
+
 	NESCPU& cpu_;
 
 	/**
-	* Gets the corrisponding nametable's index from an address that is inside the nametable.
-	* Considers the nametable mirroring type that is being used.
+	* Gets the nametable mapped to the page of an address that is inside the nametables.
+	* Remaps the pages first if the nametable mirroring type has changed.
+	*/
+	inline NESMemNameTable& GetNameTablePage(u16 addr) const
+	{
+		if (nameTablePagesMirror_ != ntMirror_)
+			UpdateNameTablePages();
+
+		return *nameTablePages_[(addr >> 10) & 3];
+	}
+
+	/**
+	* Maps the nametable pages for the nametable mirroring type that is being used.
 	*/
-	std::size_t GetNameTableIndex(u16 addr) const;
+	void UpdateNameTablePages() const;
 };
 
@@ -0,0 +1,131 @@
+#include "NESPPURenderWorker.h"
+#include "NESPPUCompositor.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace
+{
+	/**
+	* Gets the palette address of the background pixel drawn on the specified cycle of a recorded scanline,
+	* or 0 if the pixel is transparent.
+	*/
+	inline u8 GetBackgroundPixel(const NESPPUScanlineRecord& record, const NESPPUBGShiftRegisters& bgShifters, unsigned int cycle)
+	{
+		if ((cycle <= 7 && !NESHelper::IsBitSet(record.PPUMASK, NES_PPU_REG_PPUMASK_m_BIT)) ||
+			!NESHelper::IsBitSet(record.PPUMASK, NES_PPU_REG_PPUMASK_b_BIT))
+			return 0;
+
+		return bgShifters.GetPixel((cycle % 8) + (record.xScroll & 7));
+	}
+}
+
+
+NESPPURenderWorker::NESPPURenderWorker() :
+submittedCount_(0),
+drawnCount_(0),
+isStopping_(false)
+{
+	thread_ = std::thread(&NESPPURenderWorker::WorkerMain, this);
+}
+
+
+NESPPURenderWorker::~NESPPURenderWorker()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		isStopping_ = true;
+	}
+
+	jobSubmitted_.notify_one();
+	thread_.join();
+}
+
+
+void NESPPURenderWorker::Submit(unsigned int scanline, u16* frameLine)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		assert(submittedCount_ - drawnCount_ < jobs_.size() && "Too many scanlines submitted without finishing!");
+
+		auto& job = jobs_[submittedCount_ % jobs_.size()];
+		job.scanline = scanline;
+		job.frameLine = frameLine;
+
+		++submittedCount_;
+	}
+
+	jobSubmitted_.notify_one();
+}
+
+
+void NESPPURenderWorker::Finish()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	jobsFinished_.wait(lock, [this] { return drawnCount_ == submittedCount_; });
+}
+
+
+bool NESPPURenderWorker::CompositeScanline(const NESPPUScanlineRecord& record, NESPPUCompositorLine& outLine)
+{
+	// Apply PPUMASK to the sprites drawn on this scanline.
+	NESPPUCompositorLine bgLine, spriteLine;
+	if (record.hasSprites && NESHelper::IsBitSet(record.PPUMASK, NES_PPU_REG_PPUMASK_s_BIT))
+	{
+		spriteLine = record.spriteLine;
+		if (!NESHelper::IsBitSet(record.PPUMASK, NES_PPU_REG_PPUMASK_M_BIT))
+			std::fill(spriteLine.begin(), spriteLine.begin() + 7, 0);
+	}
+	else
+		spriteLine.fill(0);
+
+	// Replay the shift registers in the same way as NESPPU::TickScanline(), where each
+	// fetched tile is loaded on the last cycle of the tile being drawn.
+	auto bgShifters = record.bgShifters;
+	for (unsigned int tileCycle = 0; tileCycle < 256; tileCycle += 8)
+	{
+		for (unsigned int cycle = tileCycle + 1; cycle < tileCycle + 8; ++cycle)
+			bgLine[cycle - 1] = GetBackgroundPixel(record, bgShifters, cycle);
+
+		bgShifters.Reload(record.bgTiles[tileCycle / 8]);
+		bgLine[tileCycle + 7] = GetBackgroundPixel(record, bgShifters, tileCycle + 8);
+	}
+
+	return NESPPUCompositor::CompositeLine(bgLine, spriteLine, outLine);
+}
+
+
+void NESPPURenderWorker::DrawScanline(const NESPPUScanlineRecord& record, u16* frameLine)
+{
+	NESPPUCompositorLine compositedLine;
+	CompositeScanline(record, compositedLine);
+
+	for (unsigned int x = 0; x < NES_PPU_FRAME_WIDTH; ++x)
+		frameLine[x] = record.palettePixels[compositedLine[x]];
+}
+
+
+void NESPPURenderWorker::WorkerMain()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	while (true)
+	{
+		jobSubmitted_.wait(lock, [this] { return isStopping_ || drawnCount_ != submittedCount_; });
+
+		// Finish drawing everything that was submitted before stopping.
+		if (drawnCount_ == submittedCount_)
+			return;
+
+		// The job can't be overwritten until it has been drawn, so it can be used without holding the lock.
+		const Job job = jobs_[drawnCount_ % jobs_.size()];
+		lock.unlock();
+
+		DrawScanline(records_[job.scanline], job.frameLine);
+
+		lock.lock();
+		if (++drawnCount_ == submittedCount_)
+			jobsFinished_.notify_all();
+	}
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "NESTypes.h"
+#include "NESPPU.h"
+
+/**
+* Everything needed to draw a visible scanline that was rendered in one go by the PPU, recorded on the emulation thread.
+* The background tiles are recorded as they were fetched, so that the record doesn't depend on the
+* scroll, nametables or CHR banks at the time that it is drawn.
+*/
+struct NESPPUScanlineRecord
+{
+	/* The background shift registers at the start of the scanline, holding the first two tiles. */
+	NESPPUBGShiftRegisters bgShifters;
+
+	/* The tiles fetched on cycles 1 - 256, which are loaded into the shift registers on the last cycle of each tile. */
+	std::array<NESPPUBGFetchLatches, 32> bgTiles;
+
+	/* Fine X scroll and PPUMASK during the scanline. */
+	u8 xScroll, PPUMASK;
+
+	/* Whether or not any sprites are drawn on the scanline, and the sprite line they were rasterized to (if so). */
+	bool hasSprites;
+	NESPPUCompositorLine spriteLine;
+
+	/* The frame buffer pixels of the 32 palette entries during the scanline. */
+	std::array<u16, 0x20> palettePixels;
+
+	NESPPUScanlineRecord() :
+		xScroll(0), PPUMASK(0),
+		hasSprites(false)
+	{ }
+};
+
+/**
+* Draws the pixels of recorded scanlines into a frame buffer on its own thread, so that the
+* emulation thread only has to keep up with the PPU's timing (fetches, scroll and PPUSTATUS).
+*/
+class NESPPURenderWorker
+{
+public:
+	NESPPURenderWorker();
+	~NESPPURenderWorker();
+
+	/**
+	* Gets the record of a visible scanline, which can be written to until it is submitted.
+	* The record of a submitted scanline can't be written to again until Finish() is called.
+	*/
+	inline NESPPUScanlineRecord& GetRecord(unsigned int scanline) { return records_[scanline]; }
+
+	/**
+	* Queues the record of a visible scanline to be drawn into frameLine (the first pixel of the scanline in a frame buffer).
+	*/
+	void Submit(unsigned int scanline, u16* frameLine);
+
+	/**
+	* Waits until every submitted scanline has been drawn.
+	*/
+	void Finish();
+
+	/**
+	* Composites the background and sprite pixels of a recorded scanline into palette addresses.
+	* Returns true if a sprite-0 hit happened anywhere on the scanline.
+	*/
+	static bool CompositeScanline(const NESPPUScanlineRecord& record, NESPPUCompositorLine& outLine);
+
+	/**
+	* Draws a recorded scanline into frameLine.
+	*/
+	static void DrawScanline(const NESPPUScanlineRecord& record, u16* frameLine);
+
+private:
+	/**
+	* A submitted scanline waiting to be drawn.
+	*/
+	struct Job
+	{
+		unsigned int scanline;
+		u16* frameLine;
+	};
+
+	std::array<NESPPUScanlineRecord, NES_PPU_FRAME_HEIGHT> records_;
+
+	// Submitted jobs are queued in a ring, which can hold every visible scanline.
+	// The counts only ever increase, and both are guarded by mutex_.
+	std::array<Job, NES_PPU_FRAME_HEIGHT> jobs_;
+	u64 submittedCount_, drawnCount_;
+	bool isStopping_;
+
+	std::mutex mutex_;
+	std::condition_variable jobSubmitted_, jobsFinished_;
+	std::thread thread_;
+
+	/**
+	* Entry point of the worker thread.
+	*/
+	void WorkerMain();
+};
@@ -0,0 +1,63 @@
+#include "NESTestStatusMonitor.h"
+
+
+NESTestStatusMonitor::NESTestStatusMonitor(const ResultCallback& resultCallback) :
+resultCallback_(resultCallback),
+hasResult_(false),
+resultCode_(0)
+{
+}
+
+
+NESTestStatusMonitor::~NESTestStatusMonitor()
+{
+}
+
+
+bool NESTestStatusMonitor::HasSignature(const INESMemoryInterface& mem)
+{
+	return (mem.Read8(NES_TEST_STATUS_SIGNATURE_ADDR) == 0xDE &&
+		mem.Read8(NES_TEST_STATUS_SIGNATURE_ADDR + 1) == 0xB0 &&
+		mem.Read8(NES_TEST_STATUS_SIGNATURE_ADDR + 2) == 0x61);
+}
+
+
+std::string NESTestStatusMonitor::ReadMessage(const INESMemoryInterface& mem)
+{
+	std::string message;
+
+	for (u16 addr = NES_TEST_STATUS_MESSAGE_ADDR; addr < 0x8000; ++addr)
+	{
+		const u8 c = mem.Read8(addr);
+		if (c == 0)
+			break;
+
+		message += static_cast<char>(c);
+	}
+
+	return message;
+}
+
+
+bool NESTestStatusMonitor::OnWrite(const INESMemoryInterface& mem, u16 addr)
+{
+	// Only writes to the status or the signature can change the state of the test.
+	if (hasResult_ || addr >= NES_TEST_STATUS_MESSAGE_ADDR || !HasSignature(mem))
+		return false;
+
+	const u8 status = mem.Read8(NES_TEST_STATUS_ADDR);
+
+	if (status == NES_TEST_STATUS_RUNNING)
+		return false;
+	else if (status == NES_TEST_STATUS_NEEDS_RESET)
+		return (addr == NES_TEST_STATUS_ADDR);
+
+	resultCode_ = status;
+	message_ = ReadMessage(mem);
+	hasResult_ = true;
+
+	if (resultCallback_)
+		resultCallback_(resultCode_, message_);
+
+	return false;
+}
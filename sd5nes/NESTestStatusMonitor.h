@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+
+#include "NESTypes.h"
+#include "NESMemory.h"
+
+/* The start and end of the test status page ($6000 - $60FF). */
+#define NES_TEST_STATUS_PAGE_START 0x6000
+#define NES_TEST_STATUS_PAGE_END 0x60FF
+
+/* Addresses of the test status, signature and message text. */
+#define NES_TEST_STATUS_ADDR 0x6000
+#define NES_TEST_STATUS_SIGNATURE_ADDR 0x6001
+#define NES_TEST_STATUS_MESSAGE_ADDR 0x6004
+
+/* Status codes that mean that the test has not finished yet. */
+#define NES_TEST_STATUS_RUNNING 0x80
+#define NES_TEST_STATUS_NEEDS_RESET 0x81
+
+/**
+* Monitors the status of test ROMs that report their results in SRAM (such as blargg's test ROMs).
+* The status is written to $6000, followed by the signature $DE $B0 $61 at $6001 - $6003
+* and a null-terminated message at $6004.
+*
+* Only writes to the test status page are watched, so the monitor costs nothing when it isn't in use.
+*/
+class NESTestStatusMonitor
+{
+public:
+	// Callback that is called once the test has finished, with its result code and message.
+	typedef std::function<void(u8 resultCode, const std::string& message)> ResultCallback;
+
+	explicit NESTestStatusMonitor(const ResultCallback& resultCallback = nullptr);
+	~NESTestStatusMonitor();
+
+	/**
+	* Checks the test status after a write to the test status page.
+	* Returns true if the test has requested for the system to be reset.
+	*/
+	bool OnWrite(const INESMemoryInterface& mem, u16 addr);
+
+	/**
+	* Whether or not the test has finished and has a result.
+	* Safe to call from a different thread than the one emulating the NES.
+	* Once it returns true, the result code and message can also be read from that thread.
+	*/
+	inline bool HasResult() const { return hasResult_; }
+
+	/**
+	* Gets the result code of the finished test (0 if passed).
+	*/
+	inline u8 GetResultCode() const { return resultCode_; }
+
+	/**
+	* Gets the message of the finished test.
+	*/
+	inline const std::string& GetMessage() const { return message_; }
+
+private:
+	ResultCallback resultCallback_;
+
+	// Set after the result code and message are written.
+	std::atomic<bool> hasResult_;
+	u8 resultCode_;
+	std::string message_;
+
+	/**
+	* Whether or not the test status signature is present in memory.
+	*/
+	static bool HasSignature(const INESMemoryInterface& mem);
+
+	/**
+	* Reads the null-terminated message from memory.
+	*/
+	static std::string ReadMessage(const INESMemoryInterface& mem);
+};
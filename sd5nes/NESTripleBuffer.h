@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include "NESTypes.h"
+
+/* Flag set in the middle index of a triple buffer when it holds a buffer that hasn't been acquired yet. */
+#define NES_TRIPLE_BUFFER_DIRTY_FLAG 0x4
+#define NES_TRIPLE_BUFFER_INDEX_MASK 0x3
+
+/**
+* Lock-free triple buffer for handing off data from a single writer thread to a single reader thread.
+* The writer fills the back buffer and publishes it, and the reader acquires the newest published buffer.
+* Neither side ever waits for the other: buffers published before the reader acquires them are dropped.
+*/
+template <typename T>
+class NESTripleBuffer
+{
+public:
+	NESTripleBuffer() :
+	backIndex_(0),
+	middleIndex_(1),
+	frontIndex_(2)
+	{
+	}
+
+	~NESTripleBuffer() { }
+
+	/**
+	* Gets the buffer that the writer thread fills before publishing it.
+	*/
+	inline T& GetBackBuffer() { return buffers_[backIndex_]; }
+
+	/**
+	* Publishes the back buffer to the reader thread, replacing any buffer that it hasn't acquired yet.
+	* Should only be called from the writer thread.
+	*/
+	inline void Publish()
+	{
+		backIndex_ = middleIndex_.exchange(backIndex_ | NES_TRIPLE_BUFFER_DIRTY_FLAG, std::memory_order_acq_rel) & NES_TRIPLE_BUFFER_INDEX_MASK;
+	}
+
+	/**
+	* Makes the newest published buffer the front buffer if one was published since the last acquire.
+	* Returns true if the front buffer changed.
+	* Should only be called from the reader thread.
+	*/
+	inline bool Acquire()
+	{
+		if ((middleIndex_.load(std::memory_order_relaxed) & NES_TRIPLE_BUFFER_DIRTY_FLAG) == 0)
+			return false;
+
+		frontIndex_ = middleIndex_.exchange(frontIndex_, std::memory_order_acq_rel) & NES_TRIPLE_BUFFER_INDEX_MASK;
+		return true;
+	}
+
+	/**
+	* Gets the buffer that was last acquired by the reader thread.
+	*/
+	inline const T& GetFrontBuffer() const { return buffers_[frontIndex_]; }
+
+private:
+	std::array<T, 3> buffers_;
+
+	// Only the writer uses backIndex_ and only the reader uses frontIndex_.
+	// The middle index is swapped between them, along with the dirty flag.
+	u8 backIndex_;
+	std::atomic<u8> middleIndex_;
+	u8 frontIndex_;
+};
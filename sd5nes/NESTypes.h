@@ -5,5 +5,6 @@
 typedef std::uint8_t u8;
 typedef std::uint16_t u16;
 typedef std::uint32_t u32;
+typedef std::uint64_t u64;
 
 typedef std::int8_t s8;
\ No newline at end of file
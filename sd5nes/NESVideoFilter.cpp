@@ -0,0 +1,291 @@
+#include "NESVideoFilter.h"
+#include "NESHelper.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef NES_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+	/**
+	* Gets the mask of the alpha channel of an RGBA pixel stored as a u32.
+	*/
+	inline u32 GetAlphaMask()
+	{
+		const u8 alphaBytes[4] = { 0, 0, 0, 0xFF };
+
+		u32 alphaMask;
+		std::memcpy(&alphaMask, alphaBytes, sizeof(alphaMask));
+		return alphaMask;
+	}
+
+	/**
+	* Upscales pixel E of a row with Scale2x, from its neighbours B (above), D (left), F (right) and H (below).
+	*/
+	inline void Scale2xPixel(u32 b, u32 d, u32 e, u32 f, u32 h, u32* out0, u32* out1)
+	{
+		if (b != h && d != f)
+		{
+			out0[0] = (d == b ? d : e);
+			out0[1] = (b == f ? f : e);
+			out1[0] = (d == h ? d : e);
+			out1[1] = (h == f ? f : e);
+		}
+		else
+			out0[0] = out0[1] = out1[0] = out1[1] = e;
+	}
+
+#ifdef NES_HAS_SSE2
+	/**
+	* Selects the pixels of a where mask is set, and the pixels of b everywhere else.
+	*/
+	inline __m128i Select(__m128i mask, __m128i a, __m128i b)
+	{
+		return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+	}
+#endif
+}
+
+
+NESVideoFilter::NESVideoFilter(NESVideoFilterType type, unsigned int scale) :
+type_(type),
+scale_(std::max(scale, 1u)),
+generation_(0),
+bandsLeft_(0),
+isStopping_(false)
+{
+	if (type_ == NESVideoFilterType::SCANLINES)
+		scale_ = std::max(scale_, 2u);
+	else if (type_ == NESVideoFilterType::SCALE2X)
+		scale_ += (scale_ % 2);
+
+	source_.resize(NES_PPU_FRAME_WIDTH * NES_PPU_FRAME_HEIGHT);
+	output_.resize(GetOutputWidth() * GetOutputHeight());
+
+	// Leave a core for the emulation thread.
+	const unsigned int threadCount = std::min(std::max(std::thread::hardware_concurrency(), 2u) - 1, static_cast<unsigned int>(NES_VIDEO_FILTER_MAX_THREADS));
+	for (unsigned int band = 1; band < threadCount; ++band)
+		workers_.emplace_back(&NESVideoFilter::WorkerMain, this, band);
+}
+
+
+NESVideoFilter::~NESVideoFilter()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		isStopping_ = true;
+	}
+
+	bandsReady_.notify_all();
+	for (auto& worker : workers_)
+		worker.join();
+}
+
+
+const std::vector<u32>& NESVideoFilter::Apply(const NESPPUFrameRGBA& frame)
+{
+	std::memcpy(source_.data(), frame.data(), frame.size());
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		++generation_;
+		bandsLeft_ = static_cast<unsigned int>(workers_.size());
+	}
+
+	bandsReady_.notify_all();
+	FilterBand(0);
+
+	std::unique_lock<std::mutex> lock(mutex_);
+	bandsFinished_.wait(lock, [this] { return bandsLeft_ == 0; });
+
+	return output_;
+}
+
+
+void NESVideoFilter::WorkerMain(unsigned int band)
+{
+	u64 filteredGeneration = 0;
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	while (true)
+	{
+		bandsReady_.wait(lock, [this, filteredGeneration] { return isStopping_ || generation_ != filteredGeneration; });
+		if (isStopping_)
+			return;
+
+		filteredGeneration = generation_;
+		lock.unlock();
+
+		FilterBand(band);
+
+		lock.lock();
+		if (--bandsLeft_ == 0)
+			bandsFinished_.notify_one();
+	}
+}
+
+
+void NESVideoFilter::FilterBand(unsigned int band)
+{
+	const unsigned int bandCount = static_cast<unsigned int>(workers_.size()) + 1;
+	const unsigned int firstRow = (band * NES_PPU_FRAME_HEIGHT) / bandCount;
+	const unsigned int endRow = ((band + 1) * NES_PPU_FRAME_HEIGHT) / bandCount;
+
+	const std::size_t outWidth = GetOutputWidth();
+
+	for (unsigned int y = firstRow; y < endRow; ++y)
+	{
+		const u32* row = &source_[y * NES_PPU_FRAME_WIDTH];
+		u32* outRow = &output_[y * scale_ * outWidth];
+
+		if (type_ == NESVideoFilterType::SCALE2X)
+		{
+			// Rows at the edges of the frame are their own neighbours.
+			const u32* above = (y > 0 ? row - NES_PPU_FRAME_WIDTH : row);
+			const u32* below = (y + 1 < NES_PPU_FRAME_HEIGHT ? row + NES_PPU_FRAME_WIDTH : row);
+
+			std::array<u32, NES_PPU_FRAME_WIDTH * 2> scaledRow0, scaledRow1;
+			Scale2xRow(above, row, below, scaledRow0.data(), scaledRow1.data());
+
+			// Each of the 2 rows fills half of the output rows of this source row.
+			const unsigned int halfScale = scale_ / 2;
+			ScaleRowNearest(scaledRow0.data(), scaledRow0.size(), outRow, halfScale);
+			ScaleRowNearest(scaledRow1.data(), scaledRow1.size(), outRow + (halfScale * outWidth), halfScale);
+
+			for (unsigned int i = 1; i < halfScale; ++i)
+			{
+				std::copy(outRow, outRow + outWidth, outRow + (i * outWidth));
+				std::copy(outRow + (halfScale * outWidth), outRow + ((halfScale + 1) * outWidth), outRow + ((halfScale + i) * outWidth));
+			}
+		}
+		else
+		{
+			ScaleRowNearest(row, NES_PPU_FRAME_WIDTH, outRow, scale_);
+			for (unsigned int i = 1; i < scale_; ++i)
+				std::copy(outRow, outRow + outWidth, outRow + (i * outWidth));
+
+			if (type_ == NESVideoFilterType::SCANLINES)
+				DarkenRow(outRow + ((scale_ - 1) * outWidth), outWidth);
+		}
+	}
+}
+
+
+#ifdef NES_HAS_SSE2
+
+void NESVideoFilter::ScaleRowNearest(const u32* row, std::size_t width, u32* outRow, unsigned int scale)
+{
+	if (scale == 2 && width % 4 == 0)
+	{
+		for (std::size_t x = 0; x < width; x += 4)
+		{
+			const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&row[x]));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&outRow[x * 2]), _mm_unpacklo_epi32(pixels, pixels));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&outRow[(x * 2) + 4]), _mm_unpackhi_epi32(pixels, pixels));
+		}
+	}
+	else if (scale % 4 == 0)
+	{
+		for (std::size_t x = 0; x < width; ++x)
+		{
+			const __m128i pixel = _mm_set1_epi32(static_cast<int>(row[x]));
+			for (unsigned int i = 0; i < scale; i += 4)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(&outRow[(x * scale) + i]), pixel);
+		}
+	}
+	else
+	{
+		for (std::size_t x = 0; x < width; ++x)
+			std::fill_n(outRow + (x * scale), scale, row[x]);
+	}
+}
+
+
+void NESVideoFilter::DarkenRow(u32* row, std::size_t width)
+{
+	const u32 alphaMask = GetAlphaMask();
+	const __m128i alpha = _mm_set1_epi32(static_cast<int>(alphaMask));
+	const __m128i halfMask = _mm_set1_epi8(0x7F);
+
+	std::size_t x = 0;
+	for (; x + 4 <= width; x += 4)
+	{
+		const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&row[x]));
+		const __m128i darkened = _mm_and_si128(_mm_srli_epi16(pixels, 1), halfMask);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&row[x]), _mm_or_si128(darkened, alpha));
+	}
+
+	for (; x < width; ++x)
+		row[x] = ((row[x] >> 1) & 0x7F7F7F7F) | alphaMask;
+}
+
+
+void NESVideoFilter::Scale2xRow(const u32* above, const u32* row, const u32* below, u32* outRow0, u32* outRow1)
+{
+	// The pixels at the edges of the row are their own neighbours, so they're done separately.
+	Scale2xPixel(above[0], row[0], row[0], row[1], below[0], &outRow0[0], &outRow1[0]);
+
+	std::size_t x = 1;
+	for (; x + 4 < NES_PPU_FRAME_WIDTH; x += 4)
+	{
+		const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&above[x]));
+		const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&row[x - 1]));
+		const __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&row[x]));
+		const __m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&row[x + 1]));
+		const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&below[x]));
+
+		// Pixels are only changed where B != H and D != F.
+		const __m128i isEdge = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi32(b, h), _mm_cmpeq_epi32(d, f)), _mm_set1_epi32(-1));
+
+		const __m128i e0 = Select(_mm_and_si128(isEdge, _mm_cmpeq_epi32(d, b)), d, e);
+		const __m128i e1 = Select(_mm_and_si128(isEdge, _mm_cmpeq_epi32(b, f)), f, e);
+		const __m128i e2 = Select(_mm_and_si128(isEdge, _mm_cmpeq_epi32(d, h)), d, e);
+		const __m128i e3 = Select(_mm_and_si128(isEdge, _mm_cmpeq_epi32(h, f)), f, e);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&outRow0[x * 2]), _mm_unpacklo_epi32(e0, e1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&outRow0[(x * 2) + 4]), _mm_unpackhi_epi32(e0, e1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&outRow1[x * 2]), _mm_unpacklo_epi32(e2, e3));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&outRow1[(x * 2) + 4]), _mm_unpackhi_epi32(e2, e3));
+	}
+
+	for (; x < NES_PPU_FRAME_WIDTH; ++x)
+	{
+		const u32 right = row[std::min<std::size_t>(x + 1, NES_PPU_FRAME_WIDTH - 1)];
+		Scale2xPixel(above[x], row[x - 1], row[x], right, below[x], &outRow0[x * 2], &outRow1[x * 2]);
+	}
+}
+
+#else
+
+void NESVideoFilter::ScaleRowNearest(const u32* row, std::size_t width, u32* outRow, unsigned int scale)
+{
+	for (std::size_t x = 0; x < width; ++x)
+		std::fill_n(outRow + (x * scale), scale, row[x]);
+}
+
+
+void NESVideoFilter::DarkenRow(u32* row, std::size_t width)
+{
+	const u32 alphaMask = GetAlphaMask();
+
+	for (std::size_t x = 0; x < width; ++x)
+		row[x] = ((row[x] >> 1) & 0x7F7F7F7F) | alphaMask;
+}
+
+
+void NESVideoFilter::Scale2xRow(const u32* above, const u32* row, const u32* below, u32* outRow0, u32* outRow1)
+{
+	for (std::size_t x = 0; x < NES_PPU_FRAME_WIDTH; ++x)
+	{
+		// The pixels at the edges of the row are their own neighbours.
+		const u32 left = row[x > 0 ? x - 1 : x];
+		const u32 right = row[std::min<std::size_t>(x + 1, NES_PPU_FRAME_WIDTH - 1)];
+		Scale2xPixel(above[x], left, row[x], right, below[x], &outRow0[x * 2], &outRow1[x * 2]);
+	}
+}
+
+#endif
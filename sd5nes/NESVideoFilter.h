@@ -0,0 +1,97 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "NESTypes.h"
+#include "NESPPU.h"
+
+/**
+* The different types of video filters.
+*/
+enum class NESVideoFilterType
+{
+	NEAREST, // Nearest-neighbour integer scaling.
+	SCANLINES, // Nearest-neighbour scaling with the last row of every scanline darkened.
+	SCALE2X // Edge-directed 2x upscaling (Scale2x / EPX), followed by nearest-neighbour scaling up to the rest of the scale.
+};
+
+/* The most threads that the bands of a frame are split between, including the thread applying the filter. */
+#define NES_VIDEO_FILTER_MAX_THREADS 4
+
+/**
+* Scales and filters the RGBA frames output by the emulator.
+* Frames are split into horizontal bands that are filtered in parallel by a small pool of worker threads
+* and the thread applying the filter, which should be the render thread rather than the emulation thread.
+*/
+class NESVideoFilter
+{
+public:
+	/**
+	* Creates a filter with an integer scale. Scale2x needs an even scale and the scanline overlay needs a scale
+	* of at least 2, so the scale is rounded up to the nearest one that the filter supports.
+	*/
+	NESVideoFilter(NESVideoFilterType type, unsigned int scale);
+	~NESVideoFilter();
+
+	inline NESVideoFilterType GetType() const { return type_; }
+	inline unsigned int GetScale() const { return scale_; }
+
+	/**
+	* Gets the width and height of the filtered frames.
+	*/
+	inline unsigned int GetOutputWidth() const { return NES_PPU_FRAME_WIDTH * scale_; }
+	inline unsigned int GetOutputHeight() const { return NES_PPU_FRAME_HEIGHT * scale_; }
+
+	/**
+	* Filters a frame, returning its RGBA pixels (one u32 per pixel, in the same byte order as the frame).
+	* The returned pixels are only valid until the next time a frame is filtered.
+	*/
+	const std::vector<u32>& Apply(const NESPPUFrameRGBA& frame);
+
+private:
+	NESVideoFilterType type_;
+	unsigned int scale_;
+
+	// The frame being filtered and the filtered frame.
+	std::vector<u32> source_;
+	std::vector<u32> output_;
+
+	// Worker i filters band i + 1 of every frame, as the thread applying the filter filters band 0.
+	// generation_ is incremented for every frame, and bandsLeft_ counts the worker bands that haven't finished.
+	std::vector<std::thread> workers_;
+	u64 generation_;
+	unsigned int bandsLeft_;
+	bool isStopping_;
+
+	std::mutex mutex_;
+	std::condition_variable bandsReady_, bandsFinished_;
+
+	/**
+	* Entry point of a worker thread.
+	*/
+	void WorkerMain(unsigned int band);
+
+	/**
+	* Filters the source rows in a band of the frame.
+	*/
+	void FilterBand(unsigned int band);
+
+	/**
+	* Scales a row of pixels horizontally by the scale.
+	*/
+	static void ScaleRowNearest(const u32* row, std::size_t width, u32* outRow, unsigned int scale);
+
+	/**
+	* Darkens a row of pixels by half, keeping them opaque.
+	*/
+	static void DarkenRow(u32* row, std::size_t width);
+
+	/**
+	* Upscales a row of the frame to 2 rows of twice the width using Scale2x,
+	* where above and below are the neighbouring rows (or the row itself at the edges of the frame).
+	*/
+	static void Scale2xRow(const u32* above, const u32* row, const u32* below, u32* outRow0, u32* outRow1);
+};
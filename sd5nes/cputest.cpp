@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+#include "NESCPU.h"
+#include "NESCPUEmuComm.h"
+#include "NESCPUTrace.h"
+#include "NESPPU.h"
+#include "NESPPUEmuComm.h"
+#include "NESGamePak.h"
+
+/* Default amount of CPU cycles to run for if no golden log is given. */
+#define NES_CPUTEST_DEFAULT_CYCLES 50000000
+
+/* Capacity of the trace buffer used with a golden log. Must hold every instruction that can execute between two PPU syncs (at most one frame). */
+#define NES_CPUTEST_TRACE_CAPACITY 0x10000
+
+
+/**
+* Gets the part of a nestest.log line that is compared against the golden log.
+* The disassembly is skipped, as we don't record the memory values that nestest.log shows after the operands.
+* Spaces are removed so that the padding of the PPU position doesn't matter.
+* If the golden log doesn't include the PPU position, then only the registers are compared.
+*/
+static std::string GetComparedFields(const std::string& line, bool includePPU)
+{
+	const auto regsPos = line.find("A:");
+	if (line.size() < 15 || regsPos == std::string::npos)
+		return line;
+
+	auto fields = line.substr(0, 15) + line.substr(regsPos, includePPU ? std::string::npos : 25);
+	fields.erase(std::remove_if(fields.begin(), fields.end(), [](char c) { return (c == ' ' || c == '\r'); }), fields.end());
+	return fields;
+}
+
+
+int main(int argc, char* argv[])
+{
+	// sd5nes_cputest <rom> [--nestest] [--log <golden log>] [--cycles <max cycles>]
+	// --nestest starts execution at $C000 like nestest's automation mode.
+	// --log diffs the executed instructions against a golden nestest.log-style log, stopping at the end of the log.
+	// --cycles limits the amount of CPU cycles to run for.
+	std::string romPath, goldenLogPath;
+	bool nestestMode = false;
+	u64 maxCycles = 0;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg(argv[i]);
+		if (arg == "--nestest")
+			nestestMode = true;
+		else if (arg == "--log" && i + 1 < argc)
+			goldenLogPath = argv[++i];
+		else if (arg == "--cycles" && i + 1 < argc)
+			maxCycles = std::strtoull(argv[++i], nullptr, 10);
+		else
+			romPath = arg;
+	}
+
+	if (romPath.empty())
+	{
+		std::cerr << "Usage: sd5nes_cputest <rom> [--nestest] [--log <golden log>] [--cycles <max cycles>]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::ifstream goldenLog;
+	if (!goldenLogPath.empty())
+	{
+		goldenLog.open(goldenLogPath);
+		if (!goldenLog)
+		{
+			std::cerr << "Could not open golden log \"" << goldenLogPath << "\"" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	else if (maxCycles == 0)
+		maxCycles = NES_CPUTEST_DEFAULT_CYCLES;
+
+	// Set up the system without any controllers or video output.
+	NESGamePak cart;
+	std::unique_ptr<NESGamePakPowerState> cartState;
+	try
+	{
+		cart.LoadROM(romPath);
+		cartState = cart.GetNewGamePakPowerState();
+	}
+	catch (const NESException& ex)
+	{
+		std::cerr << "Could not load ROM: " << ex.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	NESControllerPorts controllers = { nullptr, nullptr };
+	NESMemCPURAM cpuRam;
+	NESPPUMemory ppuMem;
+	NESCPU cpu;
+	NESPPU ppu;
+
+	NESCPUEmuComm cpuComm(cpuRam, cpu, ppu, cartState->GetMMC(), controllers);
+	NESPPUEmuComm ppuComm(ppuMem, cpu, cartState->GetMMC(), cartState->GetNameTableMirroringRef());
+
+	cpu.Initialize(cpuComm);
+	ppu.Initialize(ppuComm);
+	cpu.Power();
+	ppu.Power();
+
+	// Only trace when diffing against a golden log, so that throughput is measured without tracing.
+	std::unique_ptr<NESCPUTraceBuffer> trace;
+	if (goldenLog.is_open())
+	{
+		trace = std::make_unique<NESCPUTraceBuffer>(NES_CPUTEST_TRACE_CAPACITY);
+		cpu.SetTraceBuffer(trace.get());
+	}
+
+	if (nestestMode)
+	{
+		// Let the reset finish, then start at $C000 in the state that nestest.log expects.
+		cpu.RunUntil(7);
+
+		auto reg = cpu.GetRegisters();
+		reg.PC = 0xC000;
+		reg.SP = 0xFD;
+		reg.SetP(0x24);
+		cpu.SetRegisters(reg);
+	}
+
+	std::chrono::steady_clock::duration runTime(0);
+	u64 lineNumber = 0;
+	bool passed = true, isLogFinished = false;
+
+	while ((maxCycles == 0 || cpu.GetElapsedCycles() < maxCycles) && !cpu.IsJammed() && !isLogFinished)
+	{
+		if (trace)
+			trace->Clear();
+
+		// Run in the same way as NESEmulator::Frame(), up until the PPU's next sync event.
+		u64 targetCycle = (ppu.GetNextSyncCycle() / NES_PPU_CYCLES_PER_CPU_CYCLE) + 1;
+		if (maxCycles != 0)
+			targetCycle = std::min(targetCycle, maxCycles);
+
+		const auto runStart = std::chrono::steady_clock::now();
+		cpu.RunUntil(targetCycle);
+		ppu.CatchUp(cpu.GetElapsedCycles() * NES_PPU_CYCLES_PER_CPU_CYCLE);
+		runTime += std::chrono::steady_clock::now() - runStart;
+
+		if (!trace)
+			continue;
+
+		// Diff the instructions executed during this run against the golden log.
+		std::stringstream traceLog;
+		trace->ExportNestestLog(traceLog);
+
+		std::string traceLine, goldenLine;
+		while (std::getline(traceLog, traceLine))
+		{
+			if (!std::getline(goldenLog, goldenLine))
+			{
+				isLogFinished = true;
+				break;
+			}
+
+			++lineNumber;
+
+			const bool includePPU = (goldenLine.find("PPU:") != std::string::npos);
+			if (GetComparedFields(traceLine, includePPU) != GetComparedFields(goldenLine, includePPU))
+			{
+				std::cout << "Mismatch on line " << lineNumber << ":" << std::endl;
+				std::cout << "Expected: " << goldenLine << std::endl;
+				std::cout << "Got:      " << traceLine << std::endl;
+
+				passed = false;
+				isLogFinished = true;
+				break;
+			}
+		}
+
+		if (goldenLog.peek() == std::ifstream::traits_type::eof())
+			isLogFinished = true;
+	}
+
+	if (goldenLog.is_open() && passed)
+	{
+		if (!isLogFinished)
+		{
+			std::cout << "Stopped before the end of the golden log, after line " << lineNumber << "." << std::endl;
+			passed = false;
+		}
+		else
+			std::cout << "Matched " << lineNumber << " lines of the golden log." << std::endl;
+	}
+
+	// nestest stores the result codes of the official and unofficial opcode tests in $02 and $03.
+	if (nestestMode)
+	{
+		std::cout << "nestest result: $02 = $" << std::hex << +cpuRam.Read8(0x02)
+			<< ", $03 = $" << +cpuRam.Read8(0x03) << std::dec << std::endl;
+	}
+
+	// The CPU also counts the instructions of idle loop iterations that it skipped over.
+	const u64 instructionCount = cpu.GetElapsedInstructions();
+	const double runSeconds = std::chrono::duration<double>(runTime).count();
+	std::cout << "Executed " << instructionCount << " instructions in " << cpu.GetElapsedCycles() << " cycles ("
+		<< runSeconds << " s)." << std::endl;
+
+	if (runSeconds > 0.0)
+	{
+		std::cout << "Instructions per second: " << static_cast<u64>(instructionCount / runSeconds) << std::endl;
+		std::cout << "Cycles per second: " << static_cast<u64>(cpu.GetElapsedCycles() / runSeconds) << std::endl;
+	}
+
+	return (passed ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -1,5 +1,8 @@
+#include <algorithm>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
 
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Window/Event.hpp>
@@ -12,18 +15,53 @@
 int main(int argc, char* argv[])
 {
     // Input ROM path from command-line or from stdin if
-    // no args given
+    // no path given.
+    // --test-status reports the result of test ROMs and exits with their result code.
+    // --trace <count> records the last <count> instructions executed by the CPU, which
+    // are written to trace.log on exit or when F12 is pressed.
+    // --frame-skip <n> only outputs 1 of every <n> frames and runs the emulation without a frame rate limit (fast-forward).
+    // --filter <nearest|scanlines|scale2x> and --scale <n> scale and filter the output by an integer scale.
     std::string romPath;
-    if (argc > 1) {
-        romPath = std::string(argv[1]);
+    bool monitorTestStatus = false;
+    std::size_t traceCount = 0;
+    unsigned int frameSkip = 1;
+    std::string filterName;
+    unsigned int scale = 1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        if (arg == "--test-status")
+            monitorTestStatus = true;
+        else if (arg == "--trace" && i + 1 < argc)
+            traceCount = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--frame-skip" && i + 1 < argc)
+            frameSkip = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--filter" && i + 1 < argc)
+            filterName = argv[++i];
+        else if (arg == "--scale" && i + 1 < argc)
+            scale = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+        else
+            romPath = arg;
     }
-    else {
+
+    if (romPath.empty()) {
         std::cout << "Input ROM path: ";
         std::cin >> romPath;
     }
 
+	// Init the video filter, if the output is filtered or scaled.
+	std::unique_ptr<NESVideoFilter> videoFilter;
+	if (filterName == "scanlines")
+		videoFilter = std::make_unique<NESVideoFilter>(NESVideoFilterType::SCANLINES, scale);
+	else if (filterName == "scale2x")
+		videoFilter = std::make_unique<NESVideoFilter>(NESVideoFilterType::SCALE2X, scale);
+	else if (filterName == "nearest" || scale > 1)
+		videoFilter = std::make_unique<NESVideoFilter>(NESVideoFilterType::NEAREST, scale);
+
+	if (videoFilter)
+		scale = videoFilter->GetScale();
+
 	// Init the window.
-	sf::RenderWindow window(sf::VideoMode(NES_EMU_DEFAULT_WINDOW_WIDTH, NES_EMU_DEFAULT_WINDOW_HEIGHT), "SD5 NES");
+	sf::RenderWindow window(sf::VideoMode(NES_EMU_DEFAULT_WINDOW_WIDTH * scale, NES_EMU_DEFAULT_WINDOW_HEIGHT * scale), "SD5 NES");
 	window.setFramerateLimit(60);
 
 	// @TODO: DEBUG!
@@ -31,12 +69,49 @@ int main(int argc, char* argv[])
 	font.loadFromFile("font.ttf");
 
 	NESEmulator emu(window, font);
+	emu.SetFrameSkip(frameSkip);
+
+	if (videoFilter)
+		emu.SetVideoFilter(std::move(videoFilter));
 
 	NESStandardController controller;
     controller.SetUpDownOrLeftRightAllowed(true);
 	emu.AddController(NESControllerPort::CONTROLLER_1, controller);
 
+	NESTestStatusMonitor testMonitor([](u8 resultCode, const std::string& message)
+	{
+		std::cout << "Test status: $" << std::hex << +resultCode << std::dec << std::endl;
+		std::cout << "Message: " << std::endl << message << std::endl;
+	});
+
+	if (monitorTestStatus)
+		emu.SetTestStatusMonitor(&testMonitor);
+
+	std::unique_ptr<NESCPUTraceBuffer> trace;
+	if (traceCount > 0)
+	{
+		trace = std::make_unique<NESCPUTraceBuffer>(traceCount);
+		emu.SetCPUTraceBuffer(trace.get());
+	}
+
+	// The emulation thread writes to the trace, so it must be stopped before dumping it.
+	const auto dumpTrace = [&trace, &emu]()
+	{
+		if (!trace)
+			return;
+
+		const bool wasRunning = emu.IsEmulationThreadRunning();
+		emu.StopEmulationThread();
+
+		std::ofstream traceFile("trace.log");
+		trace->ExportNestestLog(traceFile);
+
+		if (wasRunning)
+			emu.StartEmulationThread();
+	};
+
 	emu.LoadROM(romPath);
+	emu.StartEmulationThread();
 
 	// Main loop.
 	while (window.isOpen())
@@ -51,6 +126,12 @@ int main(int argc, char* argv[])
 			case sf::Event::Closed:
 				window.close();
 				break;
+
+			// Dump the trace of the last executed instructions.
+			case sf::Event::KeyPressed:
+				if (event.key.code == sf::Keyboard::F12)
+					dumpTrace();
+				break;
 			}
 		}
 
@@ -70,9 +151,19 @@ int main(int argc, char* argv[])
 		}
 
 		window.clear();
-		emu.Frame();
+		emu.DrawLatestFrame();
 		window.display();
+
+		// Exit with the result code of the test once it has finished.
+		if (monitorTestStatus && testMonitor.HasResult())
+		{
+			emu.StopEmulationThread();
+			dumpTrace();
+			return testMonitor.GetResultCode();
+		}
 	}
 
+	emu.StopEmulationThread();
+	dumpTrace();
 	return EXIT_SUCCESS;
 }